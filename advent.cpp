@@ -1,8 +1,14 @@
+#include <array>
 #include <cstdlib>
+#include <map>
+#include <memory>
+#include <span>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include <getopt.h>
 #include <unistd.h>
 
 #ifndef DOCTEST_CONFIG_DISABLE 
@@ -16,25 +22,90 @@
 #include "chart/calculator.hpp"
 #include "chart/chart.hpp"
 #include "days/advent_days.hpp"
+#include "environment.hpp"
 #include "file_backed_buffer.hpp"
 #include "fixed_string.hpp"
 #include "graph.hpp"
+#include "json.hpp"
 #include "meta/utils.hpp"
 #include "options.hpp"
+#include "plugin.hpp"
+#include "server.hpp"
+#include "startup.hpp"
 #include "table.hpp"
 #include "timing.hpp"
 #include "types.hpp"
 
-template <usize DayIdx>
-timing_data
-run_one(report_data &data, report_timing &timing, run_options const &options) {
-  using CurrentDay = std::tuple_element_t<DayIdx, all_days>;
+//! "input/dayNN.txt" built at compile time so reaching the first solve never touches fmt
+template <u32 Number>
+constexpr inline std::array<char, 16> const input_path{[] {
+  std::array<char, 16> path{"input/day00.txt"};
+  path[9] = as<char>('0' + Number / 10);
+  path[10] = as<char>('0' + Number % 10);
+  return path;
+}()};
 
-  if (options.single.has_value() && options.single.value() != DayIdx) {
-    return {};
+//! One comparison row: a named implementation, its answers and its mean timing
+struct comparison_entry {
+  std::string name;
+  std::string part1;
+  std::string part2;
+  timing_data time;
+};
+
+//! Solve once with a fresh instance, returning timings and unformatted answers
+template <typename DayT>
+comparison_entry
+solve_once(std::string_view input) noexcept {
+  DayT day;
+  time_point t0 = clock_type::now();
+  auto const parsed = day.parse_input(input);
+  time_point t1 = clock_type::now();
+  auto const part1 = day.part1(parsed);
+  time_point t2 = clock_type::now();
+  auto const part2 = day.part2(parsed, part1);
+  time_point t3 = clock_type::now();
+  return {std::string{DayT::variant},
+          fmt::format(FMT_COMPILE("{}"), part1),
+          fmt::format(FMT_COMPILE("{}"), part2),
+          timing_data{time_in_us(t0, t1), time_in_us(t1, t2), time_in_us(t2, t3)}};
+}
+
+//! Print implementations of one day side by side with speedups relative to the first; true when answers agree
+bool
+print_comparison(run_options const &options, u32 day, std::span<comparison_entry const> entries) {
+  usize width{0};
+  for (auto const &entry : entries) {
+    width = std::max(width, std::size(entry.name));
   }
+  bool agree{true};
+  auto const &base = entries.front();
+  for (auto const &entry : entries) {
+    fmt::print(FMT_COMPILE("Day {:02} {:<{}}  {} / {}   parse {} part1 {} part2 {} total {} μs   {:.2f}x"),
+               day,
+               entry.name,
+               width,
+               options.format_answer(entry.part1),
+               options.format_answer(entry.part2),
+               options.format(entry.time.parsing),
+               options.format(entry.time.part1),
+               options.format(entry.time.part2),
+               options.format(entry.time.total()),
+               base.time.total() / entry.time.total());
+    if (entry.part1 != base.part1 or entry.part2 != base.part2) {
+      fmt::print(FMT_COMPILE(" (answers differ from {}!)"), base.name);
+      agree = false;
+    }
+    fmt::print("\n");
+  }
+  return agree;
+}
+
+template <usize DayIdx, typename CurrentDay>
+timing_data
+run_variant(report_data &data, report_timing &timing, run_options const &options) {
 
-  file_backed_buffer buffer{fmt::format(FMT_COMPILE("input/day{:02}.txt"), CurrentDay::number)};
+  file_backed_buffer buffer{std::data(input_path<CurrentDay::number>)};
   if (not buffer) {
     return {};
   }
@@ -91,15 +162,125 @@ run_one(report_data &data, report_timing &timing, run_options const &options) {
   return curr;
 }
 
-auto
-run(run_options const &options) noexcept {
-  using Result = std::tuple<timing_data, report_timing, report_data>;
-  auto result = fold<implemented_days>(
-      Result{timing_data{}, implemented_days, implemented_days},
-      []<usize Day>(Result &acc, constant_t<Day>, run_options const &opts) {
+template <usize DayIdx>
+timing_data
+run_one(report_data &data, report_timing &timing, run_options const &options) {
+  using Variants = day_variants_t<std::tuple_element_t<DayIdx, all_days>>;
+
+  if (options.single.has_value() && options.single.value() != DayIdx) {
+    return {};
+  }
+
+  // the primary implementation unless --variant names another one of this day
+  usize selected{0};
+  static_for<std::tuple_size_v<Variants>>([&]<usize V>(constant_t<V>) {
+    if (options.variant.has_value() and options.variant.value() == std::tuple_element_t<V, Variants>::variant) {
+      selected = V;
+    }
+  });
+  timing_data result{};
+  static_for<std::tuple_size_v<Variants>>([&]<usize V>(constant_t<V>) {
+    if (V == selected) {
+      result = run_variant<DayIdx, std::tuple_element_t<V, Variants>>(data, timing, options);
+    }
+  });
+  return result;
+}
+
+[[nodiscard]] bool
+has_variant(std::string_view name) noexcept {
+  bool found{false};
+  static_for<implemented_days>([&]<usize DayIdx>(constant_t<DayIdx>) {
+    using Variants = day_variants_t<std::tuple_element_t<DayIdx, all_days>>;
+    static_for<std::tuple_size_v<Variants>>([&]<usize V>(constant_t<V>) {
+      found = found or (std::tuple_element_t<V, Variants>::variant == name);
+    });
+  });
+  return found;
+}
+
+//! Calls run(i) for every contender i < contenders, repetitions times, alternating between contenders on each
+//! repetition so that all of them see the same cache and frequency conditions
+template <typename Fn>
+void
+alternate(u32 repetitions, usize contenders, Fn &&run) {
+  for (u32 rep{0}; rep < repetitions; ++rep) {
+    for (usize i{0}; i < contenders; ++i) {
+      run(i);
+    }
+  }
+}
+
+int
+compare_variants(run_options const &options) {
+  bool agree{true};
+  u32 const repetitions{options.benchmark.value_or(1)};
+  static_for<implemented_days>([&]<usize DayIdx>(constant_t<DayIdx>) {
+    using Variants = day_variants_t<std::tuple_element_t<DayIdx, all_days>>;
+    constexpr usize const count{std::tuple_size_v<Variants>};
+    if (options.single.has_value() ? options.single.value() != DayIdx : count == 1) {
+      return;
+    }
+    constexpr u32 const number{std::tuple_element_t<0, Variants>::number};
+    file_backed_buffer buffer{std::data(input_path<number>)};
+    if (not buffer) {
+      return;
+    }
+    std::array<comparison_entry, count> entries;
+    alternate(repetitions, count, [&](usize i) {
+      static_for<count>([&]<usize V>(constant_t<V>) {
+        if (V == i) {
+          auto result = solve_once<std::tuple_element_t<V, Variants>>(buffer.get_string_view());
+          result.time += entries[V].time;
+          entries[V] = std::move(result);
+        }
+      });
+    });
+    for (auto &entry : entries) {
+      entry.time /= repetitions;
+    }
+    agree = print_comparison(options, number, entries) and agree;
+  });
+  return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+using run_result = std::tuple<timing_data, report_timing, report_data>;
+
+run_result
+run_round(run_options const &options) noexcept {
+  return fold<implemented_days>(
+      run_result{timing_data{}, implemented_days, implemented_days},
+      []<usize Day>(run_result &acc, constant_t<Day>, run_options const &opts) {
         std::get<timing_data>(acc) += run_one<Day>(std::get<report_data>(acc), std::get<report_timing>(acc), opts);
       },
       options);
+}
+
+run_result
+run_interleaved(run_options const &options) noexcept {
+  // one repetition of every day per round so thermal and frequency drift is spread across all days
+  u32 const rounds{options.benchmark.value_or(1)};
+  run_options round_options{options};
+  round_options.benchmark = 1;
+  run_result result{timing_data{}, implemented_days, implemented_days};
+  for (u32 round{0}; round < rounds; ++round) {
+    auto [summary, timing, data] = run_round(round_options);
+    std::get<timing_data>(result) += summary;
+    for (usize i{0}; i < implemented_days; ++i) {
+      std::get<report_timing>(result)[i] += timing[i];
+    }
+    std::get<report_data>(result) = std::move(data);
+  }
+  std::get<timing_data>(result) /= rounds;
+  for (auto &t : std::get<report_timing>(result)) {
+    t /= rounds;
+  }
+  return result;
+}
+
+auto
+run(run_options const &options) noexcept {
+  auto result = options.interleave ? run_interleaved(options) : run_round(options);
 
   report_timing &times = std::get<report_timing>(result);
   report_data &data = std::get<report_data>(result);
@@ -130,36 +311,151 @@ run(run_options const &options) noexcept {
 }
 
 void
-minimal_run(bool quiet) {
+minimal_run(bool quiet, bool profile) {
   time_point start{clock_type::now()};
+  startup.options_parsed = start;
   static_for<implemented_days>([&]<usize DayId>(constant_t<DayId>) {
     using CurrentDay = std::tuple_element_t<DayId, all_days>;
     CurrentDay day;
-    file_backed_buffer buffer{fmt::format(FMT_COMPILE("input/day{:02}.txt"), CurrentDay::number)};
+    file_backed_buffer buffer{std::data(input_path<CurrentDay::number>)};
     auto const parsed = day.parse_input(buffer.get_string_view());
     auto const part1 = day.part1(parsed);
     (void)day.part2(parsed, part1);
+    if constexpr (DayId == 0) {
+      startup.first_solve = clock_type::now();
+    }
   });
+  startup.all_solved = clock_type::now();
   if (not quiet) {
-    fmt::print(FMT_COMPILE("{}\n"), (clock_type::now() - start));
+    fmt::print(FMT_COMPILE("{}\n"), (startup.all_solved - start));
+  }
+  if (profile) {
+    startup.report();
+  }
+}
+
+server::reply
+solve_request(u32 day_number, std::string_view input) noexcept {
+  server::reply result{.code = server::status::unknown_day};
+  static_for<implemented_days>([&]<usize DayIdx>(constant_t<DayIdx>) {
+    using CurrentDay = std::tuple_element_t<DayIdx, all_days>;
+    if (CurrentDay::number != day_number) {
+      return;
+    }
+    auto solved = solve_once<CurrentDay>(input);
+    result.code = server::status::ok;
+    result.timing = solved.time;
+    result.part1 = std::move(solved.part1);
+    result.part2 = std::move(solved.part2);
+  });
+  return result;
+}
+
+int
+serve(std::string const &socket_path, run_options const &options) {
+  u32 const workers{options.affinity.empty() ? std::max(1u, std::thread::hardware_concurrency())
+                                             : as<u32>(std::size(options.affinity))};
+  if (not server::listen_and_serve(socket_path, &solve_request, options.affinity, workers)) {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int
+run_plugins(std::vector<std::string> const &paths, run_options const &options, bool watch) {
+  using namespace std::chrono_literals;
+
+  std::vector<std::unique_ptr<day_plugin>> plugins;
+  for (auto const &path : paths) {
+    plugins.push_back(std::make_unique<day_plugin>(path));
+    if (not *plugins.back()) {
+      fprintf(stderr, "Unable to load plugin %s\n", path.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+  // plugins for the same day share one mapped input
+  std::map<u32, std::unique_ptr<file_backed_buffer>> inputs;
+  for (auto const &plugin : plugins) {
+    if (auto &buffer = inputs[plugin->day()]; not buffer) {
+      buffer = std::make_unique<file_backed_buffer>(fmt::format(FMT_COMPILE("input/day{:02}.txt"), plugin->day()));
+      if (not *buffer) {
+        fprintf(stderr, "Unable to read input for day %u\n", plugin->day());
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  u32 const repetitions{options.benchmark.value_or(1)};
+  while (true) {
+    std::vector<timing_data> timing(std::size(plugins));
+    alternate(repetitions, std::size(plugins), [&](usize i) {
+      timing[i] += plugins[i]->run(inputs[plugins[i]->day()]->get_string_view());
+    });
+    // group plugins by day so each day gets its own comparison
+    std::map<u32, std::vector<comparison_entry>> by_day;
+    for (usize i{0}; i < std::size(plugins); ++i) {
+      auto const &plugin = *plugins[i];
+      timing[i] /= repetitions;
+      by_day[plugin.day()].push_back({plugin.path(), plugin.answer(1), plugin.answer(2), timing[i]});
+    }
+    for (auto const &[day, entries] : by_day) {
+      (void)print_comparison(options, day, entries);
+    }
+    if (not watch) {
+      return EXIT_SUCCESS;
+    }
+    (void)fflush(stdout);
+    // wait for a rebuilt plugin that loads successfully before the next round
+    for (bool reloaded{false}; not reloaded;) {
+      std::this_thread::sleep_for(500ms);
+      for (auto &plugin : plugins) {
+        if (plugin->reload_if_changed()) {
+          fmt::print(FMT_COMPILE("reloaded {}\n"), plugin->path());
+          reloaded = true;
+        }
+      }
+      reloaded = reloaded and std::ranges::all_of(plugins, [](auto const &plugin) {
+                   return as<bool>(*plugin);
+                 });
+    }
   }
 }
 
 int
 main(int argc, char **argv) {
+  startup.main_entry = clock_type::now();
   run_options options{};
   bool help{false};
   bool error{false};
   bool quiet{true};
+  bool profile{false};
+  bool watch{false};
+  std::optional<std::string> socket_path{std::nullopt};
+  std::vector<std::string> plugin_paths{};
+
+  constexpr std::array const long_options{option{"serve", required_argument, nullptr, 'S'},
+                                          option{"variant", required_argument, nullptr, 'V'},
+                                          option{"all-variants", no_argument, nullptr, 'A'},
+                                          option{nullptr, 0, nullptr, 0}};
 
   while (true) {
 #ifndef DOCTEST_CONFIG_DISABLE 
-    switch (int const curr_opt{getopt(argc, argv, "Qmhtgv12TCNMd:p:b:w:")}; curr_opt) {
+    switch (int const curr_opt{getopt_long(argc,
+                                           argv,
+                                           "QPmhtgvjAFIr12TCNMa:d:l:p:b:w:S:V:",
+                                           std::data(long_options),
+                                           nullptr)};
+            curr_opt) {
     case 't':
       return doctest::Context{argc, argv}.run();
       break;
 #else
-    switch (int const curr_opt{getopt(argc, argv, "Qmhgv12TCNMd:p:b:w:")}; curr_opt) {
+    switch (int const curr_opt{getopt_long(argc,
+                                           argv,
+                                           "QPmhgvjAFIr12TCNMa:d:l:p:b:w:S:V:",
+                                           std::data(long_options),
+                                           nullptr)};
+            curr_opt) {
 #endif
     case -1:
       goto option_parsing_done;
@@ -173,6 +469,38 @@ main(int argc, char **argv) {
       }
       break;
     }
+    case 'a':
+      if (auto cpus = parse_cpu_list(optarg); cpus.has_value()) {
+        options.affinity = std::move(cpus.value());
+      } else {
+        fprintf(stderr, "Option -%c requires a CPU list (e.g. 2,3 or 0-3).\n", curr_opt);
+        error = true;
+      }
+      break;
+    case 'F':
+      options.realtime = true;
+      break;
+    case 'I':
+      options.interleave = true;
+      break;
+    case 'j':
+      options.json = true;
+      break;
+    case 'S':
+      socket_path = optarg;
+      break;
+    case 'l':
+      plugin_paths.emplace_back(optarg);
+      break;
+    case 'r':
+      watch = true;
+      break;
+    case 'V':
+      options.variant = optarg;
+      break;
+    case 'A':
+      options.all_variants = true;
+      break;
     case 'p':
       options.precision = as<u32>(atoi(optarg));
       break;
@@ -207,8 +535,11 @@ main(int argc, char **argv) {
     case 'Q':
       quiet = false;
       break;
+    case 'P':
+      profile = true;
+      break;
     case 'm':
-      minimal_run(quiet);
+      minimal_run(quiet, profile);
       exit(0);
     case 'v':
       options.visual = true;
@@ -227,7 +558,8 @@ main(int argc, char **argv) {
       break;
     }
     case '?':
-      if (optopt == 'p' || optopt == 'd') {
+      if (optopt == 'p' || optopt == 'd' || optopt == 'a' || optopt == 'b' || optopt == 'w' || optopt == 'S' ||
+          optopt == 'l' || optopt == 'V') {
         fprintf(stderr, "Option -%c requires an argument.\n", optopt);
       } else if (isprint(optopt)) {
         fprintf(stderr, "Unknown option `-%c'.\n", optopt);
@@ -245,13 +577,21 @@ main(int argc, char **argv) {
 option_parsing_done:
 
   error = error or not options.validate();
+  if (options.variant.has_value() and not has_variant(options.variant.value())) {
+    fprintf(stderr, "No day implements variant '%s'\n", options.variant.value().c_str());
+    error = true;
+  }
+  if (watch and plugin_paths.empty()) {
+    fprintf(stderr, "Cannot watch for reloads without plugins\n");
+    error = true;
+  }
 
   if (help or error) {
     fmt::print(FMT_COMPILE(R"AOC_HELP(
 Advent of Code 2022 (in Modern C++)
 (c) 2022 William Killian
 
-Usage: {} [-h|-t|[-Q] -m|[-1|-2] [-T|[[-N|-M] [-p <prec>] [-b <times>]] [-C] [-d <day_num>| -g [-w <num>]]]
+Usage: {} [-h|-t|[-Q] [-P] -m|-S <socket> [-a <cpus>]|-l <plugin>... [-r] [-b <times>]|-A [-d <day_num>] [-b <times>]|[-1|-2] [-V <name>] [-T|[[-N|-M] [-p <prec>] [-b <times> [-I]]] [-a <cpus>] [-F] [-C] [-j|-d <day_num>| -g [-w <num>]]]
 
     -h             show help
     -t             run tests and exit (if compiled with support)
@@ -260,8 +600,23 @@ Usage: {} [-h|-t|[-Q] -m|[-1|-2] [-T|[[-N|-M] [-p <prec>] [-b <times>]] [-C] [-d
 
     -m             minimal run
     -Q             noisy mode for minimal run
+    -P             print startup profile for minimal run (must precede -m)
+                   set ADVENT_LAUNCH_NS to the launch time to include exec + loading
+
+    -S <socket>    (--serve) answer requests on a Unix socket with a warm worker pool
+                   one worker per CPU in -a (default: one per hardware thread)
+
+    -l <plugin>    benchmark a dayNN.so plugin (repeat to A/B plugins of the same day)
+    -r             watch plugins and re-run whenever one is rebuilt
+
+    -V <name>      (--variant) run the named implementation of days that provide one
+    -A             (--all-variants) benchmark every implementation of days with several
+                   (or of the -d day), check answers agree and show speedups
 
     -b <times>     benchmark run repetition amount
+    -I             interleave benchmark repetitions across days
+    -a <cpus>      pin benchmark threads to a CPU list (e.g. 2,3 or 0-3)
+    -F             request SCHED_FIFO scheduling (requires CAP_SYS_NICE)
     -d <day_num>   run single day
     -1             only show and run part 1
     -2             only show part 2
@@ -274,6 +629,7 @@ Usage: {} [-h|-t|[-Q] -m|[-1|-2] [-T|[[-N|-M] [-p <prec>] [-b <times>]] [-C] [-d
     -v             visual mode (show bars instead of numbers for timing)
     -p <prec={}>    precision of timing output
                    for visual mode, this is the bar width (={})
+    -j             JSON output (includes CPU environment)
     -g             show graphs
     -w <width={}>  width of graphs
 )AOC_HELP"),
@@ -284,8 +640,35 @@ Usage: {} [-h|-t|[-Q] -m|[-1|-2] [-T|[[-N|-M] [-p <prec>] [-b <times>]] [-C] [-d
     return (error ? EXIT_FAILURE : EXIT_SUCCESS);
   }
 
+  if (not pin_current_thread(options.affinity)) {
+    fprintf(stderr, "Unable to pin to the requested CPU list\n");
+    return EXIT_FAILURE;
+  }
+  if (options.realtime and not request_realtime()) {
+    fprintf(stderr, "Warning: SCHED_FIFO not permitted; continuing with the default policy\n");
+    options.realtime = false;
+  }
+  if (not governors_are_performance(options.affinity)) {
+    fprintf(stderr, "Warning: CPU frequency governor is not set to performance\n");
+  }
+
+  if (socket_path.has_value()) {
+    return serve(socket_path.value(), options);
+  }
+  if (not plugin_paths.empty()) {
+    return run_plugins(plugin_paths, options, watch);
+  }
+  if (options.all_variants) {
+    return compare_variants(options);
+  }
+
   auto [summary, timing, entries] = run(options);
 
+  if (options.json) {
+    json_output(options, capture_environment(options.affinity, options.realtime), timing, entries, summary);
+    return EXIT_SUCCESS;
+  }
+
   print(options, entries, summary);
 
   if (options.graphs) {
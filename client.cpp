@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <fmt/compile.h>
+#include <fmt/core.h>
+
+#include "file_backed_buffer.hpp"
+#include "server.hpp"
+#include "timing.hpp"
+#include "types.hpp"
+
+struct client_options {
+  std::string socket_path{};
+  std::string input_path{};
+  u32 day{0};
+  u32 requests{1000};
+  u32 connections{1};
+  bool send_path{false};
+};
+
+[[nodiscard]] static bool
+run_connection(client_options const &options,
+               std::string_view payload,
+               u32 requests,
+               std::vector<double> &latencies,
+               server::reply &last) noexcept {
+  int const fd{server::connect_to(options.socket_path)};
+  if (fd < 0) {
+    return false;
+  }
+  auto const kind = options.send_path ? server::payload_kind::path : server::payload_kind::bytes;
+  bool ok{true};
+  for (u32 r{0}; ok and r < requests; ++r) {
+    time_point t0 = clock_type::now();
+    ok = server::send_request(fd, options.day, kind, payload) and server::receive_reply(fd, last) and
+         last.code == server::status::ok;
+    time_point t1 = clock_type::now();
+    latencies.push_back(time_in_us(t0, t1));
+  }
+  (void)close(fd);
+  return ok;
+}
+
+[[nodiscard]] static double
+percentile(std::vector<double> const &sorted, double p) noexcept {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  auto const idx = as<usize>(p * as<double>(sorted.size() - 1));
+  return sorted[idx];
+}
+
+int
+main(int argc, char **argv) {
+  client_options options{};
+  bool error{false};
+
+  while (true) {
+    switch (int const curr_opt{getopt(argc, argv, "hfs:d:i:n:c:")}; curr_opt) {
+    case -1:
+      goto option_parsing_done;
+    case 's':
+      options.socket_path = optarg;
+      break;
+    case 'd':
+      options.day = as<u32>(strtoul(optarg, NULL, 10));
+      break;
+    case 'i':
+      options.input_path = optarg;
+      break;
+    case 'n':
+      options.requests = as<u32>(strtoul(optarg, NULL, 10));
+      break;
+    case 'c':
+      options.connections = std::max(1u, as<u32>(strtoul(optarg, NULL, 10)));
+      break;
+    case 'f':
+      options.send_path = true;
+      break;
+    default:
+      error = true;
+    }
+  }
+option_parsing_done:
+
+  if (options.socket_path.empty() or options.day == 0 or options.requests == 0) {
+    error = true;
+  }
+  if (error) {
+    fmt::print(stderr,
+               FMT_COMPILE(R"AOC_HELP(
+Advent of Code 2022 load generator
+
+Usage: {} -s <socket> -d <day_num> [-i <input>] [-n <requests=1000>] [-c <connections=1>] [-f]
+
+    -s <socket>    socket of a running `advent --serve`
+    -d <day_num>   day to request
+    -i <input>     input file (default: input/dayNN.txt)
+    -n <requests>  total requests to send
+    -c <conns>     concurrent connections, one thread each
+    -f             send the input path for the server to mmap instead of the bytes
+)AOC_HELP"),
+               argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (options.input_path.empty()) {
+    options.input_path = fmt::format(FMT_COMPILE("input/day{:02}.txt"), options.day);
+  }
+
+  file_backed_buffer const buffer{options.input_path};
+  if (not buffer) {
+    fmt::print(stderr, "Unable to read {}\n", options.input_path);
+    return EXIT_FAILURE;
+  }
+  std::string_view const payload{options.send_path ? std::string_view{options.input_path}
+                                                   : buffer.get_string_view()};
+
+  std::vector<std::vector<double>> latencies(options.connections);
+  std::vector<server::reply> replies(options.connections);
+  std::vector<u8> success(options.connections, 0);
+  std::vector<std::thread> threads;
+
+  time_point start = clock_type::now();
+  for (u32 c{0}; c < options.connections; ++c) {
+    u32 const share{options.requests / options.connections + (c < options.requests % options.connections ? 1u : 0u)};
+    latencies[c].reserve(share);
+    threads.emplace_back([&, c, share] {
+      success[c] = run_connection(options, payload, share, latencies[c], replies[c]);
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  time_point stop = clock_type::now();
+
+  if (std::ranges::any_of(success, [](u8 ok) {
+        return ok == 0;
+      })) {
+    fmt::print(stderr, "Request failed (server unreachable or returned an error)\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<double> all;
+  all.reserve(options.requests);
+  for (auto const &l : latencies) {
+    all.insert(std::end(all), std::begin(l), std::end(l));
+  }
+  std::ranges::sort(all);
+
+  auto const &reply = replies.front();
+  double const elapsed{time_in_us(start, stop)};
+  fmt::print("Day {:02}: {} / {}\n", options.day, reply.part1, reply.part2);
+  fmt::print("server time (μs): parse {:.2f}  part1 {:.2f}  part2 {:.2f}\n",
+             reply.timing.parsing,
+             reply.timing.part1,
+             reply.timing.part2);
+  fmt::print("{} requests over {} connections in {:.1f} ms: {:.0f} req/s\n",
+             options.requests,
+             options.connections,
+             elapsed / 1000.0,
+             as<double>(options.requests) * 1e6 / elapsed);
+  fmt::print("latency (μs): p50 {:.1f}  p90 {:.1f}  p99 {:.1f}  p99.9 {:.1f}  max {:.1f}\n",
+             percentile(all, 0.50),
+             percentile(all, 0.90),
+             percentile(all, 0.99),
+             percentile(all, 0.999),
+             all.back());
+  return EXIT_SUCCESS;
+}
@@ -1,41 +1,75 @@
+#include <bit>
+
 #include "days/day01.hpp"
 #include "parsing.hpp"
 
-PARSE_IMPL(Day01, view) {
+namespace {
+
+constexpr usize const block_size{64};
+
+//! bit i is set when block[i] is a newline; written as a flat compare loop so it vectorizes
+[[nodiscard]] inline u64
+newline_mask(char const *block) noexcept {
+  u64 mask{0};
+  for (usize i{0}; i < block_size; ++i) {
+    mask |= u64{block[i] == '\n'} << i;
+  }
+  return mask;
+}
+
+//! Sum each blank-line separated group and keep the K largest sums
+template <usize K>
+[[nodiscard]] top_k<u32, K>
+top_groups(std::string_view view) noexcept {
+  top_k<u32, K> result;
+  char const *const base{std::data(view)};
+  usize const size{std::size(view)};
   u32 sum{0};
-  std::array<u32, 3> top3{0, 0, 0};
-  for (usize off{0}; off < std::size(view);) {
-    u32 val;
-    usize const len = parse<"\0\n">(view.substr(off), val);
-    off += len;
-    if (len > 1) {
-      sum += val;
-    } else {
-      if (sum > top3[2]) {
-        if (sum > top3[1]) {
-          top3[2] = top3[1];
-          if (sum > top3[0]) {
-            top3[1] = top3[0];
-            top3[0] = sum;
-          } else {
-            top3[1] = sum;
-          }
-        } else {
-          top3[2] = sum;
-        }
-      }
+  usize line_start{0};
+  auto const end_line = [&](usize nl) noexcept {
+    std::string_view const line{base + line_start, nl - line_start};
+    if (line.empty()) {
+      result.push(sum);
       sum = 0;
+    } else if (line_start + 8 <= size and std::size(line) <= 8) {
+      sum += parse_digits8(line);
+    } else {
+      sum += parse<u32>(line);
+    }
+    line_start = nl + 1;
+  };
+  usize offset{0};
+  for (; offset + block_size <= size; offset += block_size) {
+    for (u64 mask{newline_mask(base + offset)}; mask != 0; mask &= mask - 1) {
+      end_line(offset + as<usize>(std::countr_zero(mask)));
     }
   }
-  return top3;
+  for (; offset < size; ++offset) {
+    if (base[offset] == '\n') {
+      end_line(offset);
+    }
+  }
+  if (line_start < size) {
+    end_line(size);
+  }
+  if (sum != 0) {
+    result.push(sum);
+  }
+  return result;
+}
+
+} // namespace
+
+PARSE_IMPL(Day01, view) {
+  return top_groups<3>(view);
 }
 
-PART1_IMPL(Day01, data) {
-  return data[0];
+PART1_IMPL(Day01, elves) {
+  return elves.front();
 }
 
-PART2_IMPL(Day01, data, part1_answer) {
-  return data[0] + data[1] + data[2];
+PART2_IMPL(Day01, elves, part1_answer) {
+  return elves.sum();
 }
 
 INSTANTIATE_TEST(Day01,
@@ -58,3 +92,22 @@ INSTANTIATE_TEST(Day01,
 )"sv.substr(1),
                  24000,
                  45000)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("top_k with only negative values") {
+  top_k<i32, 3> network;
+  top_k<i32, 32> heap;
+  for (i32 const value : {-7, -3, -9, -5}) {
+    network.push(value);
+    heap.push(value);
+  }
+  CHECK_EQ(network.front(), -3);
+  CHECK_EQ(network.sum(), -15);
+  CHECK_EQ(heap.front(), -3);
+  CHECK_EQ(heap.sum(), -24);
+  top_k<i32, 3> partial;
+  partial.push(-4);
+  CHECK_EQ(partial.size(), 1u);
+  CHECK_EQ(partial.sum(), -4);
+}
+#endif
@@ -1,7 +1,7 @@
 #include <numeric>
 
 #include "days/day02.hpp"
-#include "parsing.hpp"
+#include "histogram.hpp"
 
 template <bool Part2>
 consteval day02::lookup_table_t
@@ -13,12 +13,20 @@ make_cost_table() noexcept {
   }
 }
 
-PARSE_IMPL(Day02, view) {
-  day02::lookup_table_t counts{};
-  for (usize idx{0}; idx < std::size(view); idx += 4) {
-    ++counts[as<u32>(view[idx] - 'A') * day02::options + as<u32>(view[idx + 2] - 'X')];
+//! "A X\n" read as a little-endian u32, with the separators masked out
+consteval std::array<u32, day02::product>
+make_record_patterns() noexcept {
+  std::array<u32, day02::product> result{};
+  for (u32 them{0}; them < day02::options; ++them) {
+    for (u32 us{0}; us < day02::options; ++us) {
+      result[them * day02::options + us] = ('A' + them) | (('X' + us) << 16);
+    }
   }
-  return counts;
+  return result;
+}
+
+PARSE_IMPL(Day02, view) {
+  return count_records(view, make_record_patterns(), 0x00FF00FFU);
 }
 
 SOLVE_IMPL(Day02, Part2, parse_result, part1_answer) {
@@ -1,53 +1,72 @@
 #include <bit>
-#include <numeric>
+#include <cstring>
 
 #include "days/day03.hpp"
 #include "parsing.hpp"
 
 namespace {
 
+constexpr usize const lanes{4};
+typedef u64 lanes_t __attribute__((vector_size(lanes * sizeof(u64))));
+
 [[gnu::always_inline, nodiscard]] inline u64
-hash(std::string_view s) noexcept {
-  return std::accumulate(std::begin(s), std::end(s), 0LU, [](u64 hash, char c) noexcept {
-    auto const offset = as<u32>(c - (c >= 'a' ? 'a' : 'A' - 26));
-    return hash | (1LU << offset);
-  });
+priority_bit(char c) noexcept {
+  auto const offset = as<u32>(c - (c >= 'a' ? 'a' : 'A' - 26));
+  return 1LU << offset;
+}
+
+//! Set of item priorities (bit 0 is 'a', bit 26 is 'A') in s, four letters per step
+/*! Letters are widened to 64-bit lanes, mapped to priorities with a compare-and-add, and turned into bits with a
+ *  per-lane variable shift; the lanes are OR-reduced once at the end.
+ */
+[[gnu::always_inline, nodiscard]] inline u64
+item_set(char const *s, usize length) noexcept {
+  lanes_t bits{};
+  usize i{0};
+  for (; i + lanes <= length; i += lanes) {
+    u32 chunk;
+    std::memcpy(&chunk, s + i, sizeof(chunk));
+    lanes_t const c{chunk & 0xFFLU, (chunk >> 8) & 0xFFLU, (chunk >> 16) & 0xFFLU, chunk >> 24};
+    // uppercase letters wrap below 'a' and are brought back up to 26 + (c - 'A')
+    lanes_t const offset{(c - 'a') + ((c < 'a') & ('a' - 'A' + 26))};
+    bits |= (lanes_t{} + 1) << offset;
+  }
+  u64 result{bits[0] | bits[1] | bits[2] | bits[3]};
+  for (; i < length; ++i) {
+    result |= priority_bit(s[i]);
+  }
+  return result;
 }
 
 } // namespace
 
 PARSE_IMPL(Day03, view) {
-  day03::list_t result;
+  day03::totals result;
+  u64 group{~0LU};
+  u32 members{0};
   for (usize off{0}; off < std::size(view);) {
-    usize const sz{view.find_first_of('\n', off) - off};
-    result.push(view.substr(off, sz));
-    off += sz + 1;
+    usize const end{std::min(view.find('\n', off), std::size(view))};
+    usize const half{(end - off) / 2};
+    u64 const left{item_set(std::data(view) + off, half)};
+    u64 const right{item_set(std::data(view) + off + half, half)};
+    result.misplaced += std::countr_zero(left & right) + 1;
+    group &= left | right;
+    if (++members == 3) {
+      result.badges += std::countr_zero(group) + 1;
+      group = ~0LU;
+      members = 0;
+    }
+    off = end + 1;
   }
   return result;
 }
 
-PART1_IMPL(Day03, lines) {
-  return std::accumulate(std::begin(lines), std::end(lines), 0, [](int acc, std::string_view line) {
-    usize const mid{line.size() / 2};
-    u64 const l = hash(line.substr(0, mid));
-    u64 const r = hash(line.substr(mid));
-    return acc + std::countr_zero(l & r) + 1;
-  });
+PART1_IMPL(Day03, totals) {
+  return totals.misplaced;
 }
 
-PART2_IMPL(Day03, lines, part1_answer) {
-  int answer{0};
-  int count{0};
-  u64 set{0xFFFFFFFFFFFFFFFFLU};
-  for (auto line : lines) {
-    set &= hash(line);
-    if (++count == 3) {
-      answer += std::countr_zero(set) + 1;
-      count = 0;
-      set = 0xFFFFFFFFFFFFFFFFLU;
-    }
-  }
-  return answer;
+PART2_IMPL(Day03, totals, part1_answer) {
+  return totals.badges;
 }
 
 INSTANTIATE_TEST(Day03,
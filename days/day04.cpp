@@ -1,26 +1,98 @@
-#include <numeric>
+#include <cstring>
 
 #include "days/day04.hpp"
-#include "owning_span.hpp"
-#include "parsing.hpp"
+
+namespace {
+
+constexpr usize const lanes{8};
+typedef u32 lanes_t __attribute__((vector_size(lanes * sizeof(u32))));
+typedef i32 mask_t __attribute__((vector_size(lanes * sizeof(i32))));
+
+static_assert(day04::BATCH_SIZE % lanes == 0);
+
+//! Evaluate both predicates for the first `size` assignments of a batch, eight per step
+void
+count_batch(day04::batch &batch, u32 size, day04::counts &result) noexcept {
+  // pad to a whole step with a pair that neither contains nor overlaps: [1, 0] and [~0, ~0]
+  for (u32 i{size}; i % lanes != 0; ++i) {
+    batch.a_lo[i] = 1;
+    batch.a_hi[i] = 0;
+    batch.b_lo[i] = ~0u;
+    batch.b_hi[i] = ~0u;
+  }
+  mask_t contained{};
+  mask_t overlapping{};
+  auto const load = [](std::array<u32, day04::BATCH_SIZE> const &lane, u32 i) noexcept {
+    lanes_t v;
+    std::memcpy(&v, std::data(lane) + i, sizeof(v));
+    return v;
+  };
+  for (u32 i{0}; i < size; i += lanes) {
+    lanes_t const a_lo{load(batch.a_lo, i)};
+    lanes_t const a_hi{load(batch.a_hi, i)};
+    lanes_t const b_lo{load(batch.b_lo, i)};
+    lanes_t const b_hi{load(batch.b_hi, i)};
+    // comparisons yield -1 per true lane
+    contained -= ((a_lo >= b_lo) & (a_hi <= b_hi)) | ((b_lo >= a_lo) & (b_hi <= a_hi));
+    overlapping -= (b_lo <= a_hi) & (a_lo <= b_hi);
+  }
+  for (usize l{0}; l < lanes; ++l) {
+    result.contained += as<u32>(contained[l]);
+    result.overlapping += as<u32>(overlapping[l]);
+  }
+}
+
+//! Read an unsigned number at curr and step over the separator that follows it
+/*! Only the final line of an input without a trailing newline needs the end check
+ */
+template <bool Bounded>
+[[gnu::always_inline]] inline u32
+next_number(char const *&curr, char const *end) noexcept {
+  u32 value{as<u32>(*curr++ - '0')};
+  while ((not Bounded or curr < end) and *curr >= '0') {
+    value = value * 10 + as<u32>(*curr++ - '0');
+  }
+  ++curr;
+  return value;
+}
+
+} // namespace
 
 PARSE_IMPL(Day04, view) {
-  owning_span<day04::range, day04::MAX_RANGES> ranges;
-  for (usize off{0}; off < std::size(view);) {
-    u32 a, b, c, d;
-    off += parse<"\0-\1,\2-\3\n">(view.substr(off), a, b, c, d);
-    ranges.push({{a, b}, {c, d}});
+  day04::counts result;
+  day04::batch batch;
+  u32 size{0};
+  auto const parse_line = [&]<bool Bounded>(char const *&curr, char const *end) noexcept {
+    batch.a_lo[size] = next_number<Bounded>(curr, end);
+    batch.a_hi[size] = next_number<Bounded>(curr, end);
+    batch.b_lo[size] = next_number<Bounded>(curr, end);
+    batch.b_hi[size] = next_number<Bounded>(curr, end);
+    if (++size == day04::BATCH_SIZE) {
+      count_batch(batch, size, result);
+      size = 0;
+    }
+  };
+  char const *curr{std::data(view)};
+  char const *const end{curr + std::size(view)};
+  // every line up to the last newline is terminated, so its digit loops cannot run off the end
+  char const *const terminated{curr + view.find_last_of('\n') + 1};
+  while (curr < terminated) {
+    parse_line.operator()<false>(curr, end);
+  }
+  if (curr < end) {
+    parse_line.operator()<true>(curr, end);
   }
-  return ranges;
+  count_batch(batch, size, result);
+  return result;
 }
 
-SOLVE_IMPL(Day04, Part2, ranges, part1_answer) {
-  return std::accumulate(std::begin(ranges), std::end(ranges), 0u, [](u32 sum, day04::range const &r) {
-    return sum + as<u32>(Part2 ? r.overlaps() : r.encloses());
-  });
+PART1_IMPL(Day04, counts) {
+  return counts.contained;
 }
 
-INSTANTIATE(Day04);
+PART2_IMPL(Day04, counts, part1_answer) {
+  return counts.overlapping;
+}
 
 INSTANTIATE_TEST(Day04,
                  R"(
@@ -1,19 +1,91 @@
 #include "days/day05.hpp"
-#include "owning_span.hpp"
 #include "parsing.hpp"
 
 namespace day05 {
+
+void
+ropes_t::push_down(u32 t) noexcept {
+  if (node &n = nodes[t]; n.flip) {
+    std::swap(n.left, n.right);
+    if (n.left != nil) {
+      nodes[n.left].flip = not nodes[n.left].flip;
+    }
+    if (n.right != nil) {
+      nodes[n.right].flip = not nodes[n.right].flip;
+    }
+    n.flip = false;
+  }
+}
+
+void
+ropes_t::update(u32 t) noexcept {
+  nodes[t].size = 1u + size(nodes[t].left) + size(nodes[t].right);
+}
+
+[[nodiscard]] u32
+ropes_t::merge(u32 a, u32 b) noexcept {
+  if (a == nil) {
+    return b;
+  } else if (b == nil) {
+    return a;
+  } else if (nodes[a].priority > nodes[b].priority) {
+    push_down(a);
+    nodes[a].right = merge(nodes[a].right, b);
+    update(a);
+    return a;
+  } else {
+    push_down(b);
+    nodes[b].left = merge(a, nodes[b].left);
+    update(b);
+    return b;
+  }
+}
+
+[[nodiscard]] std::pair<u32, u32>
+ropes_t::split(u32 t, u32 k) noexcept {
+  if (t == nil) {
+    return {nil, nil};
+  }
+  push_down(t);
+  if (size(nodes[t].left) >= k) {
+    auto const [a, b] = split(nodes[t].left, k);
+    nodes[t].left = b;
+    update(t);
+    return {a, t};
+  } else {
+    auto const [a, b] = split(nodes[t].right, k - size(nodes[t].left) - 1u);
+    nodes[t].right = a;
+    update(t);
+    return {t, b};
+  }
+}
+
+[[nodiscard]] char
+ropes_t::top(u32 t) noexcept {
+  while (true) {
+    push_down(t);
+    if (nodes[t].right == nil) {
+      return nodes[t].crate;
+    }
+    t = nodes[t].right;
+  }
+}
+
+//! Move the top count crates; one at a time (not Bulk) lands them reversed, which is a lazy flag on the moved tree
 template <bool Bulk>
 [[gnu::always_inline]] inline void
-command::execute(stacks_t &stacks) const noexcept {
-  stack_t &src = stacks[from];
-  stack_t &dst = stacks[to];
-  if constexpr (auto elems = src.top(count); Bulk) {
-    dst.push(std::begin(elems), count);
-  } else {
-    dst.push(std::rbegin(elems), count);
+ropes_t::execute(command const &c) noexcept {
+  u32 &src = roots[c.from];
+  u32 &dst = roots[c.to];
+  auto const [rest, moved] = split(src, size(src) - c.count);
+  if (moved == nil) {
+    return;
+  }
+  if constexpr (not Bulk) {
+    nodes[moved].flip = not nodes[moved].flip;
   }
-  src.pop(count);
+  src = rest;
+  dst = merge(dst, moved);
 }
 
 } // namespace day05
@@ -35,7 +107,7 @@ PARSE_IMPL(Day05, view) {
     // offsets of values:   1   5   9   13 ...   (4s + 1)
     for (u32 idx{0}; auto &s : state.stacks) {
       if (char const c{view[off + (idx << 2) + 1]}; c != ' ') {
-        s.push(c);
+        s.push_back(c);
       }
       ++idx;
     }
@@ -55,32 +127,82 @@ PARSE_IMPL(Day05, view) {
   while (off < std::size(view)) {
     u32 count{0}, src{0}, dst{0};
     off += parse<"move \0 from \1 to \2\n">(view.substr(off), count, src, dst);
-    state.commands.push({count, src - 1, dst - 1});
+    state.commands.push_back({count, src - 1, dst - 1});
   }
   return state;
 }
 
 SOLVE_IMPL(Day05, Part2, state, part1_answer) {
+  std::vector<std::string> stacks{state.stacks};
+
+  for (auto const &command : state.commands) {
+    std::string &src = stacks[command.from];
+    std::string &dst = stacks[command.to];
+    if constexpr (Part2) {
+      dst.append(std::end(src) - command.count, std::end(src));
+    } else {
+      dst.append(std::rbegin(src), std::rbegin(src) + command.count);
+    }
+    src.resize(std::size(src) - command.count);
+  }
+
+  std::string result;
+  result.reserve(std::size(stacks));
+  for (auto const &s : stacks) {
+    if (not s.empty()) {
+      result.push_back(s.back());
+    }
+  }
+  return result;
+}
+
+INSTANTIATE(Day05);
+
+PARSE_IMPL(Day05Rope, view) {
+  auto [stacks, commands] = Day05{}.parse_input(view);
+
+  // build each stack bottom to top
+  day05::rope_state state{.stacks = {}, .commands = std::move(commands)};
+  state.stacks.roots.assign(std::size(stacks), day05::nil);
+  u32 priority{0x9E3779B9u};
+  for (u32 idx{0}; auto const &s : stacks) {
+    for (char const c : s) {
+      // xorshift32
+      priority ^= priority << 13;
+      priority ^= priority >> 17;
+      priority ^= priority << 5;
+      u32 const id{as<u32>(std::size(state.stacks.nodes))};
+      state.stacks.nodes.push_back({.priority = priority, .crate = c});
+      state.stacks.roots[idx] = state.stacks.merge(state.stacks.roots[idx], id);
+    }
+    ++idx;
+  }
+  return state;
+}
+
+SOLVE_IMPL(Day05Rope, Part2, state, part1_answer) {
 
   day05::commands_t const &commands{state.commands};
-  day05::stacks_t stacks{state.stacks};
+  day05::ropes_t stacks{state.stacks};
 
   // simulate
   for (auto &&command : commands) {
-    command.execute<Part2>(stacks);
+    stacks.execute<Part2>(command);
   }
 
   // accumulate into buffer
-  owning_span<char, day05::MAX_STACKS> result;
-  result.resize(0);
-  for (auto const &s : stacks) {
-    result.push(s.top());
+  std::string result;
+  result.reserve(std::size(stacks.roots));
+  for (u32 const root : stacks.roots) {
+    if (root != day05::nil) {
+      result.push_back(stacks.top(root));
+    }
   }
 
-  return std::string{std::begin(result), std::end(result)};
+  return result;
 }
 
-INSTANTIATE(Day05);
+INSTANTIATE(Day05Rope);
 
 INSTANTIATE_TEST(Day05,
                  R"(
@@ -96,3 +218,18 @@ move 1 from 1 to 2
 )"sv.substr(1),
                  "CMZ"sv,
                  "MCD"sv)
+
+INSTANTIATE_TEST(Day05Rope,
+                 R"(
+    [D]    
+[N] [C]    
+[Z] [M] [P]
+ 1   2   3 
+
+move 1 from 2 to 1
+move 3 from 1 to 3
+move 2 from 2 to 1
+move 1 from 1 to 2
+)"sv.substr(1),
+                 "CMZ"sv,
+                 "MCD"sv)
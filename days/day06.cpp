@@ -1,36 +1,78 @@
-#include <algorithm>
-#include <bit>
-#include <numeric>
-
 #include "days/day06.hpp"
-#include "parsing.hpp"
+#include "distinct_window.hpp"
 
-PARSE_IMPL(Day06, view) {
-  typename day06::buffer_t mapped(as<u32>(std::size(view)) - 1);
-  std::transform(std::begin(view), std::end(view) - 1, std::begin(mapped), [](char c) {
-    return c - 'a';
-  });
-  return mapped;
+namespace {
+
+[[nodiscard]] inline std::span<u8 const>
+as_bytes(std::string_view view) noexcept {
+  return {reinterpret_cast<u8 const *>(std::data(view)), std::size(view)};
 }
 
-SOLVE_IMPL(Day06, Part2, data, part1_answer) {
-  constexpr u32 const window{Part2 ? 14 : 4};
-  for (auto i{std::begin(data) + part1_answer.value_or(window)}; i < std::end(data); ++i) {
-    u32 const set{std::accumulate(i - window, i, 0u, [](u32 num, i8 idx) {
-      return num | (1 << idx);
-    })};
-    if (std::popcount(set) == window) [[unlikely]] {
-      return std::distance(std::begin(data), i);
-    }
+//! a distinct window of 14 contains distinct windows of 4, so part 2 cannot end before part 1 + 10
+template <bool Part2>
+[[nodiscard]] inline usize
+resume_offset(std::optional<i64> const &part1_answer) noexcept {
+  return (Part2 and part1_answer.value_or(-1) >= 4) ? as<usize>(*part1_answer - 4) : 0;
+}
+
+} // namespace
+
+PARSE_IMPL(Day06, view) {
+  while (not view.empty() and view.back() == '\n') {
+    view.remove_suffix(1);
   }
-  return u32(-1);
+  return view;
+}
+
+SOLVE_IMPL(Day06, Part2, signal, part1_answer) {
+  constexpr usize const window{Part2 ? 14 : 4};
+  usize const offset{resume_offset<Part2>(part1_answer)};
+  auto const end = first_distinct_window(as_bytes(signal).subspan(offset), window);
+  return end.has_value() ? as<i64>(offset + *end) : -1;
 }
 
 INSTANTIATE(Day06);
 
+PARSE_IMPL(Day06Lanes, view) {
+  return Day06{}.parse_input(view);
+}
+
+SOLVE_IMPL(Day06Lanes, Part2, signal, part1_answer) {
+  constexpr usize const window{Part2 ? 14 : 4};
+  usize const offset{resume_offset<Part2>(part1_answer)};
+  auto const end = first_distinct_window_letters(as_bytes(signal).subspan(offset), window);
+  return end.has_value() ? as<i64>(offset + *end) : -1;
+}
+
+INSTANTIATE(Day06Lanes);
+
 INSTANTIATE_TEST(Day06,
                  R"(
 mjqjpqmgbljsphdztnvjfqwrcgsmlb
 )"sv.substr(1),
                  7L,
                  19L)
+
+INSTANTIATE_TEST(Day06Lanes,
+                 R"(
+mjqjpqmgbljsphdztnvjfqwrcgsmlb
+)"sv.substr(1),
+                 7L,
+                 19L)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("distinct windows wider than the alphabet and outside one 32-symbol block") {
+  std::string cycle;
+  for (int i{0}; i < 1000; ++i) {
+    cycle += as<char>('a' + i % 26);
+  }
+  CHECK_EQ(first_distinct_window(as_bytes(cycle), 26).value_or(0), 26);
+  CHECK_FALSE(first_distinct_window(as_bytes(cycle), 27).has_value());
+  CHECK_FALSE(first_distinct_window_letters(as_bytes(cycle), 27).has_value());
+  CHECK_FALSE(first_distinct_window_letters(as_bytes(cycle), 40).has_value());
+  // 'a' and 'A' are equal modulo 32, so the lanes engine has to hand this to the byte counts
+  std::string_view const mixed{"aAaAaAaAaAbBcC"};
+  CHECK_EQ(first_distinct_window(as_bytes(mixed), 4).value_or(0), 12);
+  CHECK_EQ(first_distinct_window_letters(as_bytes(mixed), 4).value_or(0), 12);
+}
+#endif
@@ -1,54 +1,284 @@
-#include <iterator>
+#include <algorithm>
+#include <bit>
+#include <functional>
 #include <numeric>
 
 #include "days/day07.hpp"
-#include "owning_span.hpp"
 #include "parsing.hpp"
 
-PARSE_IMPL(Day07, view) {
+namespace day07 {
+
+namespace {
+
+constexpr u32 const empty_slot{~0u};
+// parent of the interned-name entries, and the tag that marks them in m_slots
+constexpr u32 const interned{~0u};
+constexpr u32 const name_entry{1u << 31};
+
+[[nodiscard]] inline usize
+name_hash(std::string_view name) noexcept {
+  return std::hash<std::string_view>{}(name);
+}
 
-  owning_span<u32, day07::MAX_DIRS> sizes;
-  owning_span<u32, day07::MAX_DEPTH> dir_stack;
+} // namespace
+
+[[nodiscard]] usize
+filesystem::find_slot(u32 parent, std::string_view child_name, usize hash) const noexcept {
+  usize const mask{std::size(m_slots) - 1};
+  for (usize slot{(hash ^ (usize{parent} * 0x9E3779B97F4A7C15LU)) & mask};; slot = (slot + 1) & mask) {
+    u32 const entry{m_slots[slot]};
+    if (entry == empty_slot) {
+      return slot;
+    }
+    u32 const dir{entry & ~name_entry};
+    if (((entry & name_entry) ? interned : m_dirs[dir].parent) == parent and name(dir) == child_name) {
+      return slot;
+    }
+  }
+}
 
-  for (usize off{0}; off < std::size(view);) {
-    if ('0' <= view[off] and view[off] <= '9') {
-      u32 size;
-      off += parse<"\0 ">(view.substr(off), size);
-      for (auto &dir : dir_stack) {
-        dir += size;
+u32
+filesystem::add_child(u32 parent, std::string_view child_name) {
+  usize const hash{name_hash(child_name)};
+  if (u32 const known{m_slots[find_slot(parent, child_name, hash)]}; known != empty_slot) {
+    return known;
+  }
+  u32 const dir{as<u32>(std::size(m_dirs))};
+  usize const name_slot{find_slot(interned, child_name, hash)};
+  u32 name_offset;
+  if (u32 const first{m_slots[name_slot]}; first != empty_slot) {
+    name_offset = m_dirs[first & ~name_entry].name_offset;
+  } else {
+    name_offset = as<u32>(std::size(m_names));
+    m_names += child_name;
+    m_slots[name_slot] = dir | name_entry;
+    ++m_entries;
+  }
+  m_dirs.push_back(
+      directory{.name_offset = name_offset, .name_length = as<u32>(std::size(child_name)), .parent = parent});
+  // the name entry may have taken the slot the first lookup found
+  m_slots[find_slot(parent, child_name, hash)] = dir;
+  ++m_entries;
+  if (2 * m_entries > std::size(m_slots)) {
+    // double the table and reinsert every directory but the root, which is nobody's child, and every name
+    m_slots.assign(2 * std::size(m_slots), empty_slot);
+    for (u32 i{1}; i < std::size(m_dirs); ++i) {
+      usize const rehash{name_hash(name(i))};
+      m_slots[find_slot(m_dirs[i].parent, name(i), rehash)] = i;
+      if (usize const slot{find_slot(interned, name(i), rehash)}; m_slots[slot] == empty_slot) {
+        m_slots[slot] = i | name_entry;
       }
-    } else if (view.substr(off + 2, 2) == "cd"sv) {
-      off += 5; // advance to directory name
-      if (view[off] == '.') {
-        sizes.push(dir_stack.top());
-        dir_stack.pop();
+    }
+  }
+  return dir;
+}
+
+void
+filesystem::index_children() {
+  // counting sort by parent; the root is nobody's child
+  m_child_begin.assign(std::size(m_dirs) + 1, 0);
+  for (u32 i{1}; i < std::size(m_dirs); ++i) {
+    ++m_child_begin[m_dirs[i].parent + 1];
+  }
+  std::partial_sum(std::begin(m_child_begin), std::end(m_child_begin), std::begin(m_child_begin));
+  m_children.resize(std::size(m_dirs) - 1);
+  std::vector<u32> next{std::begin(m_child_begin), std::prev(std::end(m_child_begin))};
+  for (u32 i{1}; i < std::size(m_dirs); ++i) {
+    m_children[next[m_dirs[i].parent]++] = i;
+  }
+  for (u32 dir{0}; dir < std::size(m_dirs); ++dir) {
+    std::ranges::sort(std::begin(m_children) + m_child_begin[dir],
+                      std::begin(m_children) + m_child_begin[dir + 1],
+                      std::less{},
+                      [this](u32 child) { return name(child); });
+  }
+}
+
+// a directory needs a few log lines of its own, so sizing by the log keeps the table from growing on typical input
+filesystem::filesystem(std::string_view log)
+    : m_slots(std::max(usize{64}, std::bit_ceil(std::size(log) / 16)), empty_slot) {
+  m_dirs.push_back(directory{.name_offset = 0, .name_length = 1, .parent = 0});
+  m_names.push_back('/');
+  u32 cwd{0};
+  bool listing{false};
+  for (usize off{0}; off < std::size(log);) {
+    usize const eol{std::min(log.find('\n', off), std::size(log))};
+    std::string_view const line{log.substr(off, eol - off)};
+    off = eol + 1;
+    if (line.starts_with("$ cd ")) {
+      listing = false;
+      if (std::string_view const target{line.substr(5)}; target == "/") {
+        cwd = 0;
+      } else if (target == "..") {
+        cwd = m_dirs[cwd].parent;
       } else {
-        dir_stack.push(0u);
+        cwd = add_child(cwd, target);
       }
+    } else if (line == "$ ls") {
+      // listing a directory twice must not count its files twice
+      listing = not m_dirs[cwd].listed;
+      m_dirs[cwd].listed = true;
+    } else if (not listing) {
+      continue;
+    } else if (line.starts_with("dir ")) {
+      add_child(cwd, line.substr(4));
+    } else {
+      m_dirs[cwd].file_bytes += parse<u64>(line.substr(0, line.find(' ')));
+    }
+  }
+  // only the replay looks (parent, name) pairs up; queries walk the child ranges
+  m_slots = {};
+  index_children();
+
+  // children always come after their parent, so walking backwards is a post-order pass
+  for (auto &dir : m_dirs) {
+    dir.total_bytes = dir.file_bytes;
+  }
+  for (usize i{std::size(m_dirs) - 1}; i > 0; --i) {
+    m_dirs[m_dirs[i].parent].total_bytes += m_dirs[i].total_bytes;
+  }
+
+  m_totals.reserve(std::size(m_dirs));
+  for (auto const &dir : m_dirs) {
+    m_totals.push_back(dir.total_bytes);
+  }
+  std::ranges::sort(m_totals);
+  m_prefix.resize(std::size(m_totals) + 1);
+  std::partial_sum(std::begin(m_totals), std::end(m_totals), std::begin(m_prefix) + 1);
+}
+
+[[nodiscard]] u64
+filesystem::used() const noexcept {
+  return m_dirs.front().total_bytes;
+}
+
+[[nodiscard]] std::string_view
+filesystem::name(u32 dir) const noexcept {
+  return std::string_view{m_names}.substr(m_dirs[dir].name_offset, m_dirs[dir].name_length);
+}
+
+[[nodiscard]] std::span<u32 const>
+filesystem::children(u32 dir) const noexcept {
+  return std::span{m_children}.subspan(m_child_begin[dir], m_child_begin[dir + 1] - m_child_begin[dir]);
+}
+
+[[nodiscard]] usize
+filesystem::size() const noexcept {
+  return std::size(m_dirs);
+}
+
+[[nodiscard]] std::optional<u64>
+filesystem::size_of(std::string_view path) const noexcept {
+  if (not path.starts_with('/')) {
+    return std::nullopt;
+  }
+  u32 dir{0};
+  while (not path.empty()) {
+    path.remove_prefix(1);
+    std::string_view const component{path.substr(0, path.find('/'))};
+    path.remove_prefix(std::size(component));
+    if (component.empty()) {
+      continue;
+    }
+    auto const subdirs = children(dir);
+    auto const next = std::ranges::lower_bound(subdirs, component, std::less{}, [this](u32 child) {
+      return name(child);
+    });
+    if (next == std::end(subdirs) or name(*next) != component) {
+      return std::nullopt;
     }
-    off += view.substr(off).find_first_of('\n') + 1LU;
+    dir = *next;
+  }
+  return m_dirs[dir].total_bytes;
+}
+
+[[nodiscard]] std::optional<u64>
+filesystem::smallest_at_least(u64 bytes) const noexcept {
+  auto const it = std::ranges::lower_bound(m_totals, bytes);
+  if (it == std::end(m_totals)) {
+    return std::nullopt;
   }
-  sizes.push(std::rbegin(dir_stack), std::rend(dir_stack));
-  return sizes;
+  return *it;
 }
 
-PART1_IMPL(Day07, sizes) {
-  return std::accumulate(std::begin(sizes), std::end(sizes), 0u, [](u32 acc, u32 s) {
-    return acc + (s < 100'000 ? s : 0u);
-  });
+[[nodiscard]] u64
+filesystem::sum_at_most(u64 bytes) const noexcept {
+  auto const count = std::ranges::upper_bound(m_totals, bytes) - std::begin(m_totals);
+  return m_prefix[as<usize>(count)];
 }
 
-constexpr u32 const total_space{70'000'000};
-constexpr u32 const needed_free_space{30'000'000};
+} // namespace day07
+
+PARSE_IMPL(Day07, view) {
+  return day07::filesystem{view};
+}
+
+PART1_IMPL(Day07, fs) {
+  return fs.sum_at_most(100'000);
+}
+
+constexpr u64 const total_space{70'000'000};
+constexpr u64 const needed_free_space{30'000'000};
+
+PART2_IMPL(Day07, fs, part1_answer) {
+  u64 const available_space{total_space - fs.used()};
+  u64 const need_to_free{needed_free_space > available_space ? needed_free_space - available_space : 0};
+  return fs.smallest_at_least(need_to_free).value_or(0);
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("day07::filesystem queries") {
+  day07::filesystem const fs{R"(
+$ cd /
+$ ls
+dir a
+14848514 b.txt
+8504156 c.dat
+dir d
+$ cd a
+$ ls
+dir e
+29116 f
+2557 g
+62596 h.lst
+$ cd e
+$ ls
+584 i
+$ cd ..
+$ cd ..
+$ cd d
+$ ls
+4060174 j
+8033020 d.log
+5626152 d.ext
+7214296 k
+)"sv.substr(1)};
+  CHECK_EQ(fs.size(), 4u);
+  CHECK_EQ(fs.size_of("/").value_or(0), 48381165u);
+  CHECK_EQ(fs.size_of("/a/e").value_or(0), 584u);
+  CHECK_EQ(fs.size_of("/d/").value_or(0), 24933642u);
+  CHECK(not fs.size_of("/a/x").has_value());
+  CHECK_EQ(fs.smallest_at_least(600).value_or(0), 94853u);
+  CHECK(not fs.smallest_at_least(50'000'000).has_value());
+  CHECK_EQ(fs.name(1), "a");
+  CHECK_EQ(fs.children(0).size(), 2u);
+  CHECK_EQ(fs.name(fs.children(0)[1]), "d");
+  CHECK_EQ(fs.children(2).size(), 0u);
+
+  // entered before its parent was listed, and listed twice
+  day07::filesystem const early{"$ cd /\n$ cd x\n$ ls\n5 f\n$ cd ..\n$ ls\ndir x\n$ cd x\n$ ls\n5 f\n"sv};
+  CHECK_EQ(early.size(), 2u);
+  CHECK_EQ(early.size_of("/x").value_or(0), 5u);
+  CHECK_EQ(early.used(), 5u);
 
-PART2_IMPL(Day07, sizes, part1_answer) {
-  u32 const used_space{sizes.top()};
-  u32 const available_space{total_space - used_space};
-  u32 const need_to_free{needed_free_space - available_space};
-  return std::accumulate(std::begin(sizes), std::end(sizes), 0xFFFFFFFFU, [need_to_free](u32 best_fit, u32 s) {
-    return ((s >= need_to_free && s < best_fit) ? s : best_fit);
-  });
+  // equal names under different parents share one copy
+  day07::filesystem const twins{"$ cd /\n$ ls\ndir b\ndir a\n$ cd a\n$ ls\ndir a\n$ cd a\n$ ls\n7 f\n"sv};
+  CHECK_EQ(twins.size(), 4u);
+  CHECK_EQ(twins.size_of("/a/a").value_or(0), 7u);
+  CHECK_EQ(twins.name(twins.children(0)[0]).data(), twins.name(twins.children(twins.children(0)[0])[0]).data());
+  CHECK(not twins.size_of("/b/a").has_value());
 }
+#endif
 
 INSTANTIATE_TEST(Day07,
                  R"(
@@ -1,98 +1,140 @@
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "days/day08.hpp"
 #include "parsing.hpp"
 
-PARSE_IMPL(Day08, view) {
-
-  u32 const dim = as<u32>(view.find_first_of('\n'));
-  u32 const end = dim - 1;
-
-  typename day08::grid_t grid(dim);
-  for (u32 row{0}; row < dim; ++row) {
-    grid[row] = view.substr(as<u32>(row * (dim + 1)), dim);
-  }
+namespace {
 
-  typename day08::visible_t visible(dim * dim, 0u);
-  auto vis = [&](u32 r, u32 c) -> decltype(auto) {
-    return visible[r * dim + c];
-  };
+// square tiles for walking a row-major and a column-major grid together while both stay in cache
+constexpr u32 const tile{32};
 
-  // populate visible grid
-  for (u32 j{0}; j < dim; ++j) {
-    char lmax{0}, rmax{0}, tmax{0}, bmax{0};
-    for (u32 i{0}; i < dim; ++i) {
-      if (auto const val = grid[j][i]; val > lmax) {
-        ++vis(j, i);
-        if (lmax = val; val == '9') {
-          break;
-        }
-      }
-    }
-    for (u32 i{0}; i < dim; ++i) {
-      if (auto const val = grid[j][end - i]; val > rmax) {
-        ++vis(j, end - i);
-        if (rmax = val; val == '9') {
-          break;
-        }
+//! Call fn(r, c) for every cell, one tile at a time
+template <typename Fn>
+[[gnu::always_inline]] inline void
+for_each_tiled(u32 row_begin, u32 row_end, u32 width, Fn &&fn) noexcept {
+  for (u32 c0{0}; c0 < width; c0 += tile) {
+    for (u32 r{row_begin}; r < row_end; ++r) {
+      for (u32 c{c0}; c < std::min(c0 + tile, width); ++c) {
+        fn(r, c);
       }
     }
-    for (u32 i{0}; i < dim; ++i) {
-      if (auto const val = grid[i][j]; val > tmax) {
-        ++vis(i, j);
-        if (tmax = val; val == '9') {
-          break;
-        }
+  }
+}
+
+//! Mark every tree visible from the top or the bottom edge of a row-major grid
+/*! The running maxima are one row wide, so each step is an elementwise compare and max across all columns, written
+ *  with 32-column vectors so it does not hinge on the auto-vectorizer (which leaves it scalar at -O2).
+ */
+void
+mark_from_ends(std::string_view grid, u32 width, u32 height, std::vector<u8> &visible) noexcept {
+  typedef char lane_t __attribute__((vector_size(32)));
+  constexpr u32 const lanes{sizeof(lane_t)};
+  // whole vectors of columns first, then the leftover columns one by one
+  u32 const wide{width - width % lanes};
+  std::vector<char> tallest(width);
+  for (auto const &rows : {std::pair{0u, 1}, std::pair{height - 1, -1}}) {
+    std::ranges::fill(tallest, '0' - 1);
+    for (u32 r{rows.first}, n{0}; n < height; ++n, r = as<u32>(as<i32>(r) + rows.second)) {
+      char const *const row{std::data(grid) + usize{r} * width};
+      u8 *const marks{std::data(visible) + usize{r} * width};
+      for (u32 c{0}; c < wide; c += lanes) {
+        lane_t here, top, seen;
+        std::memcpy(&here, row + c, lanes);
+        std::memcpy(&top, std::data(tallest) + c, lanes);
+        std::memcpy(&seen, marks + c, lanes);
+        seen |= (here > top) & 1;
+        top = (here > top) ? here : top;
+        std::memcpy(std::data(tallest) + c, &top, lanes);
+        std::memcpy(marks + c, &seen, lanes);
       }
-    }
-    for (u32 i{0}; i < dim; ++i) {
-      if (auto val = grid[end - i][j]; val > bmax) {
-        ++vis(end - i, j);
-        if (bmax = val; val == '9') {
-          break;
-        }
+      for (u32 c{wide}; c < width; ++c) {
+        marks[c] |= as<u8>(row[c] > tallest[c]);
+        tallest[c] = std::max(tallest[c], row[c]);
       }
     }
   }
-  return {visible, grid, dim};
 }
 
-PART1_IMPL(Day08, data) {
-
-  return std::count_if(std::begin(data.visible), std::end(data.visible), [](unsigned c) {
-    return c > 0;
-  });
+//! Product of how far each tree along one line sees towards either end
+/*! This is the monotonic-stack sweep with the stack collapsed into a table, which heights of 0-9 allow:
+ *  blocker[h] is the nearest position so far holding a tree of height >= h, so each tree reads its viewing
+ *  distance from one entry and updates the entries at or below its height in a single vector select.
+ */
+void
+view_products(char const *line, u32 length, u32 *products) noexcept {
+  typedef u32 table_t __attribute__((vector_size(16 * sizeof(u32))));
+  table_t const heights{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+  table_t blocker{};
+  for (u32 c{0}; c < length; ++c) {
+    u32 const tree{as<u32>(line[c] - '0') & 15};
+    products[c] = c - blocker[tree];
+    blocker = (heights <= tree) ? (table_t{} + c) : blocker;
+  }
+  blocker = table_t{} + (length - 1);
+  for (u32 c{length}; c-- > 0;) {
+    u32 const tree{as<u32>(line[c] - '0') & 15};
+    products[c] *= blocker[tree] - c;
+    blocker = (heights <= tree) ? (table_t{} + c) : blocker;
+  }
 }
 
-PART2_IMPL(Day08, data, part1_answer) {
+} // namespace
 
-  u32 const dim = data.size;
-  u32 const end = dim - 1;
-  auto const &grid = data.grid;
-  auto const &visible = data.visible;
+PARSE_IMPL(Day08, view) {
+  u32 const width{as<u32>(view.find('\n'))};
+  u32 const height{as<u32>((std::size(view) + 1) / (width + 1))};
+  day08::forest forest{.rows = std::string(usize{width} * height, '\0'),
+                       .columns = std::string(usize{width} * height, '\0'),
+                       .width = width,
+                       .height = height};
+  for (u32 r{0}; r < height; ++r) {
+    std::ranges::copy(view.substr(usize{r} * (width + 1), width), std::begin(forest.rows) + usize{r} * width);
+  }
+  for (u32 r0{0}; r0 < height; r0 += tile) {
+    for_each_tiled(r0, std::min(r0 + tile, height), width, [&](u32 r, u32 c) {
+      forest.columns[usize{c} * height + r] = forest.rows[usize{r} * width + c];
+    });
+  }
+  return forest;
+}
 
-  i64 high{0};
-  for (u32 y{1}; y < end; y++) {
-    for (u32 x{1}; x < end; x++) {
-      // this is an optimization which likely is not acceptable for all inputs
-      if (visible[y * dim + x] != 2u) {
-        continue;
-      }
-      auto const tree = grid[y][x];
-      i64 left{x > 0}, right{x < end}, top{y > 0}, bottom{y < end};
-      for (u32 i{x - 1}; i > 0 and grid[y][i] < tree; --i, ++left)
-        ;
-      for (u32 i{x + 1}; i < end and grid[y][i] < tree; ++i, ++right)
-        ;
-      for (u32 j{y - 1}; j > 0 and grid[j][x] < tree; --j, ++top)
-        ;
-      for (u32 j{y + 1}; j < end and grid[j][x] < tree; ++j, ++bottom)
-        ;
-      high = std::max({high, left * right * top * bottom});
-    }
+PART1_IMPL(Day08, forest) {
+  auto const &[rows, columns, width, height] = forest;
+  std::vector<u8> from_ends(usize{width} * height, 0);
+  std::vector<u8> from_sides(usize{width} * height, 0);
+  mark_from_ends(rows, width, height, from_ends);
+  mark_from_ends(columns, height, width, from_sides);
+  i64 count{0};
+  for (u32 r0{0}; r0 < height; r0 += tile) {
+    for_each_tiled(r0, std::min(r0 + tile, height), width, [&](u32 r, u32 c) {
+      count += (from_ends[usize{r} * width + c] | from_sides[usize{c} * height + r]);
+    });
   }
+  return count;
+}
 
-  return high;
+PART2_IMPL(Day08, forest, part1_answer) {
+  auto const &[rows, columns, width, height] = forest;
+  // up * down for every tree, column-major
+  std::vector<u32> vertical(usize{width} * height);
+  for (u32 c{0}; c < width; ++c) {
+    view_products(std::data(columns) + usize{c} * height, height, std::data(vertical) + usize{c} * height);
+  }
+  // left * right for a band of rows at a time
+  std::vector<u32> horizontal(usize{tile} * width);
+  u64 best{0};
+  for (u32 r0{0}; r0 < height; r0 += tile) {
+    u32 const r1{std::min(r0 + tile, height)};
+    for (u32 r{r0}; r < r1; ++r) {
+      view_products(std::data(rows) + usize{r} * width, width, std::data(horizontal) + usize{r - r0} * width);
+    }
+    for_each_tiled(r0, r1, width, [&](u32 r, u32 c) {
+      best = std::max(best, u64{horizontal[usize{r - r0} * width + c]} * vertical[usize{c} * height + r]);
+    });
+  }
+  return as<i64>(best);
 }
 
 INSTANTIATE_TEST(Day08,
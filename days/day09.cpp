@@ -1,23 +1,131 @@
+#include <algorithm>
 #include <array>
-#include <span>
+#include <bit>
+#include <unordered_map>
 
 #include "days/day09.hpp"
-#include "owning_span.hpp"
 #include "parsing.hpp"
-#include "point2d.hpp"
+
+namespace {
 
 constexpr usize const tracked_p1 = 1;
 constexpr usize const tracked_p2 = 9;
-constexpr usize const max_tracked = std::max(tracked_p1, tracked_p2);
 
-PARSE_IMPL(Day09, view) {
+inline void
+append(day09::motion &runs, point2d step, i32 count) noexcept {
+  if (count == 0) {
+    return;
+  }
+  if (not runs.empty() and runs.back().step == step) {
+    runs.back().count += count;
+  } else {
+    runs.push_back({step, count});
+  }
+}
+
+//! Motion of the knot trailing `leader`; both start at the origin
+//!
+//! Only the leader's offset matters: while the leader repeats one unit step the follower stays put until the offset
+//! along that step reaches two, is pulled once toward the leader, and from then on copies every step.
+[[nodiscard]] day09::motion
+follow(day09::motion const &leader) noexcept {
+  day09::motion result;
+  result.reserve(std::size(leader) + std::size(leader) / 2);
+  point2d offset{point2d::origin()};
+  for (auto const &[step, count] : leader) {
+    // the offset is within one on both axes and never shrinks along a moving axis, so -1 stands in for a still axis
+    i32 const ahead{std::max(step.x != 0 ? step.x * offset.x : -1, step.y != 0 ? step.y * offset.y : -1)};
+    // leader steps until the follower is first pulled
+    i32 const lag{2 - ahead};
+    if (count < lag) {
+      offset += step * count;
+      continue;
+    }
+    point2d const pull{(offset + step * lag).sgn()};
+    append(result, pull, 1);
+    append(result, step, count - lag);
+    offset += step * lag - pull;
+  }
+  return result;
+}
+
+//! Sparse set of visited cells: 64x64 bitmap tiles found through a hash of the tile coordinate
+class visited_set {
+  using tile = std::array<u64, 64>;
+
+  std::unordered_map<u64, u32> m_index;
+  std::vector<tile> m_tiles;
+  u64 m_key{~0LU};
+  tile *m_current{nullptr};
+
+  [[nodiscard]] inline tile &tile_of(point2d const &p) noexcept {
+    u64 const key{(as<u64>(as<u32>(p.y >> 6)) << 32) | as<u32>(p.x >> 6)};
+    if (key != m_key) {
+      auto [iter, inserted] = m_index.try_emplace(key, as<u32>(std::size(m_tiles)));
+      if (inserted) {
+        m_tiles.emplace_back();
+      }
+      // growing m_tiles may move every tile, so the pointer is always refreshed
+      m_key = key;
+      m_current = &m_tiles[iter->second];
+    }
+    return *m_current;
+  }
+
+public:
+  inline void mark(point2d const &p) noexcept {
+    tile_of(p)[as<u32>(p.y & 63)] |= 1LU << (p.x & 63);
+  }
+
+  //! Marks `start` and the `count` cells after it along `step`
+  inline void mark_segment(point2d start, point2d const &step, i32 count) noexcept {
+    mark(start);
+    while (count > 0) {
+      i32 const x{start.x & 63}, y{start.y & 63};
+      // cells reachable before leaving the current tile
+      i32 room{count};
+      if (step.x != 0) {
+        room = std::min(room, step.x > 0 ? 63 - x : x);
+      }
+      if (step.y != 0) {
+        room = std::min(room, step.y > 0 ? 63 - y : y);
+      }
+      if (room == 0) {
+        start += step;
+        mark(start);
+        --count;
+        continue;
+      }
+      tile &t = tile_of(start);
+      if (step.y == 0) {
+        // a horizontal segment is a single bit range within one row
+        i32 const lo{step.x > 0 ? x + 1 : x - room};
+        t[as<u32>(y)] |= (~0LU >> (64 - room)) << lo;
+      } else {
+        for (i32 i{1}; i <= room; ++i) {
+          t[as<u32>(y + step.y * i)] |= 1LU << (x + step.x * i);
+        }
+      }
+      start += step * room;
+      count -= room;
+    }
+  }
+
+  [[nodiscard]] inline i64 size() const noexcept {
+    i64 total{0};
+    for (tile const &t : m_tiles) {
+      for (u64 row : t) {
+        total += std::popcount(row);
+      }
+    }
+    return total;
+  }
+};
 
-  // keep track of a bounding box
-  i32 x_min{0}, x_max{0}, y_min{0}, y_max{0};
-  point2d location = point2d::origin();
+} // namespace
 
-  // build the command list
-  owning_span<std::pair<point2d, i32>, 2000> steps;
+PARSE_IMPL(Day09, view) {
+  day09::motion head;
   usize off{0};
   while (off < std::size(view)) {
     char d;
@@ -38,52 +146,24 @@ PARSE_IMPL(Day09, view) {
         __builtin_unreachable();
       }
     }(d);
-    steps.push({direction, distance});
-    location += direction * distance;
-    x_min = std::min(x_min, location.x);
-    x_max = std::max(x_max, location.x);
-    y_min = std::min(y_min, location.y);
-    y_max = std::max(y_max, location.y);
+    append(head, direction, distance);
   }
-
-  // a visited grid is faster than std::unordered_set
-  day09::grid_type grid(x_min, x_max, y_min, y_max);
-
-  // visit the origin
-  grid(0, 0) = (1 << tracked_p1) | (1 << tracked_p2);
-
-  // make the chain of size 10
-  std::array<point2d, 1 + max_tracked> chain;
-
-  for (auto &&[dir, distance] : steps) {
-    for (i32 move{0}; move < distance; ++move) {
-      chain[0] += dir;
-      // always simulate chain of size 10
-      for (usize k{1}; k <= max_tracked; ++k) {
-        point2d &curr = chain[k];
-        point2d const delta{chain[k - 1] - curr};
-        // prev has moved too far and need to adjust
-        if (std::abs(delta.y) > 1 or std::abs(delta.x) > 1) {
-          curr += delta.sgn();
-          // mark the location as visited only if interesting
-          if (k == tracked_p1 or k == tracked_p2) {
-            grid(curr) |= (1 << k);
-          }
-          continue;
-        }
-        break;
-      }
-    }
-  }
-
-  return grid;
+  return head;
 }
 
-SOLVE_IMPL(Day09, Part2, grid, part1_answer) {
-  constexpr u16 const mask{1 << (Part2 ? tracked_p2 : tracked_p1)};
-  return std::count_if(std::begin(grid), std::end(grid), [](u16 val) {
-    return val & mask;
-  });
+SOLVE_IMPL(Day09, Part2, head, part1_answer) {
+  day09::motion knot{follow(head)};
+  for (usize k{1}; k < (Part2 ? tracked_p2 : tracked_p1); ++k) {
+    knot = follow(knot);
+  }
+  visited_set visited;
+  point2d location{point2d::origin()};
+  visited.mark(location);
+  for (auto const &[step, count] : knot) {
+    visited.mark_segment(location, step, count);
+    location += step * count;
+  }
+  return visited.size();
 }
 
 INSTANTIATE(Day09);
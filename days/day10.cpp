@@ -1,54 +1,152 @@
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string>
 
 #include "days/day10.hpp"
 #include "letter.hpp"
-#include "owning_span.hpp"
+#include "meta/utils.hpp"
 #include "parsing.hpp"
 
-PARSE_IMPL(Day10, view) {
-  day10::xstate_t xvals;
-  i32 X{1};
-  for (usize off{0}; off < std::size(view);) {
-    xvals.push(X);
-    if (view[std::exchange(off, off + 5)] == 'a') {
+namespace day10 {
+
+namespace {
+
+struct opcode {
+  std::string_view mnemonic;
+  u32 cycles;
+  bool writes_x;
+};
+
+constexpr std::array<opcode, 2> const instruction_set{{{"noop", 1, false}, {"addx", 2, true}}};
+
+} // namespace
+
+cpu::cpu(std::string_view program) noexcept {
+  // every instruction takes at least five bytes
+  m_retire.reserve(std::size(program) / 5 + 1);
+  m_x.reserve(std::size(program) / 5 + 1);
+  i32 x{1};
+  m_x.push_back(x);
+  for (usize off{0}; off < std::size(program);) {
+    // mnemonics differ in their first letter
+    auto const op = std::ranges::find(instruction_set, program[off], [](opcode const &o) {
+      return o.mnemonic[0];
+    });
+    off += std::size(op->mnemonic) + 1;
+    m_cycles += op->cycles;
+    if (op->writes_x) {
       i32 value;
-      off += parse<"\0\n">(view.substr(off), value);
-      xvals.push(X);
-      X += value;
+      off += parse<"\0\n">(program.substr(off), value);
+      x += value;
+      m_retire.push_back(m_cycles);
+      m_x.push_back(x);
     }
   }
-  return xvals;
+  // sentinel: never retires, so searches need no bounds checks
+  m_retire.push_back(std::numeric_limits<u64>::max());
 }
 
-PART1_IMPL(Day10, xvals) {
-  // array starts at 0, not 1
-  return (20 * xvals[19] + 60 * xvals[59] + 100 * xvals[99] + 140 * xvals[139] + 180 * xvals[179] + 220 * xvals[219]);
+void
+cpu::sample(std::span<u32 const> cycles, std::span<i32> x) const noexcept {
+  usize retired{0};
+  for (usize q{0}; q < std::size(cycles); ++q) {
+    // writes land at the end of their last cycle, so only those retired before this cycle are visible
+    u64 const cycle{cycles[q]};
+    // writes are at least two cycles apart, so neighbouring cycles advance by at most one
+    retired += (m_retire[retired] < cycle);
+    if (m_retire[retired] < cycle) {
+      // gallop to distant cycles in logarithmic time
+      usize stride{1};
+      while (m_retire[retired + stride] < cycle) {
+        retired += stride;
+        stride = std::min(2 * stride, std::size(m_retire) - 1 - retired);
+      }
+      auto const first = std::begin(m_retire) + as<isize>(retired);
+      retired = as<usize>(std::partition_point(first, first + as<isize>(stride) + 1, [=](u64 r) {
+                            return r < cycle;
+                          }) -
+                          std::begin(m_retire));
+    }
+    x[q] = m_x[retired];
+  }
+}
+
+[[nodiscard]] u64
+cpu::cycles() const noexcept {
+  return m_cycles;
+}
+
+} // namespace day10
+
+PARSE_IMPL(Day10, view) {
+  return day10::cpu{view};
+}
+
+PART1_IMPL(Day10, cpu) {
+  constexpr std::array<u32, 6> const cycles{20, 60, 100, 140, 180, 220};
+  std::array<i32, std::size(cycles)> x;
+  cpu.sample(cycles, x);
+  i32 strength{0};
+  for (usize i{0}; i < std::size(cycles); ++i) {
+    strength += as<i32>(cycles[i]) * x[i];
+  }
+  return strength;
 }
 
 namespace {
-// we know the output is going to be 8 chars always
-// use a static buffer for this and always return the address
-owning_span<char, 8> screen;
+
+constexpr u32 const screen_width{40};
+constexpr u32 const screen_letters{screen_width / letter::width};
+
+typedef i32 lanes_t __attribute__((vector_size(32)));
+typedef u32 ulanes_t __attribute__((vector_size(32)));
+
+//! Lit pixels of one screen row (bit c is column c) given the sprite position during each of its 40 cycles
+[[nodiscard]] inline u64
+row_pixels(i32 const *sprite) noexcept {
+  constexpr lanes_t const column{0, 1, 2, 3, 4, 5, 6, 7};
+  constexpr lanes_t const lane_bit{1, 2, 4, 8, 16, 32, 64, 128};
+  u64 pixels{0};
+  static_for<usize{screen_width / 8}>([&]<usize K>(constant_t<K>) {
+    lanes_t x;
+    std::memcpy(&x, sprite + 8 * K, sizeof(x));
+    // |column - x| <= 1 as a single unsigned comparison
+    lanes_t const lit{(ulanes_t)(x - (column + 8 * as<i32>(K)) + 1) <= 2};
+    lanes_t const bits{lit & lane_bit};
+    u64 byte{0};
+    for (u32 i{0}; i < 8; ++i) {
+      byte |= as<u64>(bits[i]);
+    }
+    pixels |= byte << (8 * K);
+  });
+  return pixels;
+}
+
 } // namespace
 
-PART2_IMPL(Day10, xvals, part1_answer) {
-  owning_span<letter, 8> letters(8);
-  auto xv = std::begin(xvals);
-  for (u8 row{0}; row < letter::height; ++row) {
-    for (u8 idx{0}, column{0}; idx < 8; ++idx) {
-      for (u8 col{0}; col < letter::width; ++col) {
-        if (std::abs(column - *xv++) <= 1) {
-          letters[idx].set_pixel(row, col);
-        }
-        ++column;
-      }
+PART2_IMPL(Day10, cpu, part1_answer) {
+  constexpr std::array<u32, screen_width * letter::height> const cycles{[] {
+    std::array<u32, screen_width * letter::height> result;
+    std::iota(std::begin(result), std::end(result), 1u);
+    return result;
+  }()};
+  std::array<i32, std::size(cycles)> sprite;
+  cpu.sample(cycles, sprite);
+  std::array<u32, screen_letters> glyphs{};
+  for (u32 row{0}; row < letter::height; ++row) {
+    u64 const pixels{row_pixels(std::data(sprite) + row * screen_width)};
+    for (u32 idx{0}; idx < screen_letters; ++idx) {
+      glyphs[idx] |= as<u32>((pixels >> (idx * letter::width)) & 0x1F) << (row * letter::width);
     }
   }
-  screen.resize(0);
-  for (auto &&l : letters) {
-    screen.push(l.as<char>());
+  std::string screen(screen_letters, ' ');
+  for (u32 idx{0}; idx < screen_letters; ++idx) {
+    screen[idx] = letter::recognize(glyphs[idx]);
   }
-  return {screen.data(), screen.size()};
+  return screen;
 }
 
 INSTANTIATE_TEST(Day10,
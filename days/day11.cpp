@@ -1,4 +1,10 @@
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <span>
+#include <thread>
 
 #include "days/day11.hpp"
 #include "owning_span.hpp"
@@ -58,33 +64,364 @@ PARSE_IMPL(Day11, view) {
   return monkeys;
 }
 
-SOLVE_IMPL(Day11, Part2, original, part1_answer) {
-  auto monkeys = original;
-  constexpr u32 round_limit{Part2 ? 10'000u : 20u};
+namespace day11 {
 
-  for (u32 round{0}; round < round_limit; ++round) {
-    for (auto &monkey : monkeys) {
-      for (u32 item : monkey.items()) {
-        u32 const worry_level{monkey.get_op().template new_worry_level<Part2>(item)};
-        u32 const destination = monkey.get_destination(worry_level);
-        monkeys[destination].catch_item(worry_level);
+namespace {
+
+using counts_type = std::array<u64, MAX_MONKEYS>;
+
+//! Where an item waits between rounds
+struct item_state {
+  u32 holder;
+  // relief alone lets worry levels climb past 32 bits
+  u64 worry;
+
+  friend constexpr bool operator==(item_state const &, item_state const &) noexcept = default;
+};
+
+//! Follows one item on its own: items never interact, so every item can be simulated independently
+template <bool Relief>
+class item_tracer {
+  std::span<monkey const> m_monkeys;
+  u32 m_modulus{1};
+
+public:
+  explicit item_tracer(std::span<monkey const> monkeys) noexcept
+      : m_monkeys{monkeys} {
+    // only divisibility by the monkeys' own divisors matters, and a smaller modulus makes for shorter cycles
+    for (monkey const &m : monkeys) {
+      m_modulus *= m.divisor();
+    }
+  }
+
+  //! Plays one round for the item, optionally counting its inspections
+  template <bool Count>
+  [[nodiscard]] inline item_state round(item_state item, counts_type &counts) const noexcept {
+    // an item thrown to a later monkey is inspected again in the same round
+    while (true) {
+      monkey const &m = m_monkeys[item.holder];
+      if constexpr (Count) {
+        ++counts[item.holder];
+      }
+      u64 const raw{m.get_op().apply(item.worry)};
+      u64 const worry{Relief ? raw / 3 : raw % m_modulus};
+      u32 const next{m.get_destination(worry)};
+      bool const same_round{next > item.holder};
+      item = {next, worry};
+      if (not same_round) {
+        return item;
       }
-      monkey.update_throws();
     }
   }
 
-  u32 const count{std::size(monkeys)};
-  owning_span<u64, day11::MAX_MONKEYS> throws(count, 0LU);
-  for (u32 midx{0}; midx < std::size(throws); ++midx) {
-    throws[midx] = monkeys[midx].count();
+  void trace(item_state start, u64 rounds, counts_type &counts) const noexcept {
+    if constexpr (not Relief) {
+      // Brent's cycle search over the states between rounds; abandoned if it costs more than just simulating
+      counts_type unused;
+      u64 power{1}, lambda{1}, searched{1};
+      item_state tortoise{start}, hare{round<false>(start, unused)};
+      while (tortoise != hare and searched <= rounds) {
+        if (power == lambda) {
+          tortoise = hare;
+          power *= 2;
+          lambda = 0;
+        }
+        hare = round<false>(hare, unused);
+        ++lambda;
+        ++searched;
+      }
+      if (tortoise == hare) {
+        u64 mu{0};
+        tortoise = hare = start;
+        for (u64 i{0}; i < lambda; ++i) {
+          hare = round<false>(hare, unused);
+        }
+        for (; tortoise != hare; ++mu) {
+          tortoise = round<false>(tortoise, unused);
+          hare = round<false>(hare, unused);
+        }
+        if (mu + lambda <= rounds) {
+          item_state item{start};
+          for (u64 i{0}; i < mu; ++i) {
+            item = round<true>(item, counts);
+          }
+          counts_type cycle{};
+          for (u64 i{0}; i < lambda; ++i) {
+            item = round<true>(item, cycle);
+          }
+          u64 const cycles{(rounds - mu) / lambda};
+          for (u32 m{0}; m < MAX_MONKEYS; ++m) {
+            counts[m] += cycles * cycle[m];
+          }
+          for (u64 i{0}; i < (rounds - mu) % lambda; ++i) {
+            item = round<true>(item, counts);
+          }
+          return;
+        }
+      }
+    }
+    item_state item{start};
+    for (u64 i{0}; i < rounds; ++i) {
+      item = round<true>(item, counts);
+    }
   }
-  std::nth_element(std::begin(throws), std::end(throws) - 2, std::end(throws));
+};
+
+// a thread costs tens of microseconds to start, so each worker needs at least this many item rounds to trace
+constexpr u64 const rounds_per_worker{1u << 15};
+
+} // namespace
+
+template <bool Relief>
+[[nodiscard]] u64
+monkey_business(std::span<monkey const> monkeys, u64 rounds) noexcept {
+  item_tracer<Relief> const tracer{monkeys};
 
+  owning_span<item_state, MAX_MONKEYS * MAX_ITEMS> items;
+  for (u32 m{0}; m < std::size(monkeys); ++m) {
+    for (u32 worry : monkeys[m].items()) {
+      items.push(item_state{m, worry});
+    }
+  }
+
+  u32 const total{std::size(items)};
+  // short games (every part 1) stay on the calling thread
+  u64 const item_rounds{u64{total} * rounds};
+  u32 const workers{as<u32>(std::clamp(item_rounds / rounds_per_worker,
+                                       u64{1},
+                                       u64{std::max(std::min(total, std::thread::hardware_concurrency()), 1u)}))};
+  owning_span<counts_type, MAX_MONKEYS * MAX_ITEMS> partial(workers, counts_type{});
+  auto const work = [&](u32 w) noexcept {
+    for (u32 i{w}; i < total; i += workers) {
+      tracer.trace(items[i], rounds, partial[w]);
+    }
+  };
+  owning_span<std::thread, MAX_MONKEYS * MAX_ITEMS> threads;
+  for (u32 w{1}; w < workers; ++w) {
+    threads.push(std::thread(work, w));
+  }
+  work(0);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  owning_span<u64, MAX_MONKEYS> throws(as<u32>(std::size(monkeys)), 0LU);
+  for (counts_type const &counts : partial) {
+    for (u32 m{0}; m < std::size(throws); ++m) {
+      throws[m] += counts[m];
+    }
+  }
+  // fewer than two monkeys leave nobody to pair with
+  u32 const count{std::size(throws)};
+  if (count < 2) {
+    return 0;
+  }
+  std::nth_element(std::begin(throws), std::end(throws) - 2, std::end(throws));
   return throws[count - 1] * throws[count - 2];
 }
 
+template u64 monkey_business<false>(std::span<monkey const>, u64) noexcept;
+template u64 monkey_business<true>(std::span<monkey const>, u64) noexcept;
+
+namespace {
+
+typedef i64 i64x4 __attribute__((vector_size(32)));
+typedef u64 u64x4 __attribute__((vector_size(32)));
+typedef double f64x4 __attribute__((vector_size(32)));
+
+// adding 2^52 to a non-negative double rounds it to an integer
+constexpr double const two_52{4503599627370496.0};
+
+//! Division by a runtime divisor through a precomputed reciprocal, in the spirit of libdivide. Worry levels stay in
+//! doubles, where every product below 2^48 is exact: the rounded quotient is at most one too large, which the sign
+//! of the remainder corrects.
+class reciprocal {
+  double m_divisor;
+  double m_inverse;
+
+public:
+  //! dividends must stay below this
+  constexpr static double const limit{281474976710656.0};
+
+  explicit reciprocal(u32 divisor) noexcept
+      : m_divisor{as<double>(divisor)},
+        m_inverse{1.0 / as<double>(divisor)} {
+  }
+
+  inline void divide(f64x4 n, f64x4 &quotient, f64x4 &remainder) const noexcept {
+    f64x4 const estimate{(n * m_inverse + two_52) - two_52};
+    f64x4 const rem{n - estimate * m_divisor};
+    i64x4 const over{rem < 0.0};
+    quotient = over ? estimate - 1.0 : estimate;
+    remainder = over ? rem + m_divisor : rem;
+  }
+};
+
+//! Lemire's divisibility test: n * ceil(2^64 / d) wraps below ceil(2^64 / d) exactly when d divides n, for every n
+//! below 2^(64 - bits of d); divisors fit in a byte, so that covers every worry level below 2^56
+class divisibility {
+  u64 m_multiplier{1};
+
+public:
+  divisibility() noexcept = default;
+
+  explicit divisibility(u32 divisor) noexcept
+      : m_multiplier{std::numeric_limits<u64>::max() / divisor + 1u} {
+  }
+
+  [[nodiscard]] inline i64x4 test(u64x4 n) const noexcept {
+    return (n * m_multiplier) < m_multiplier;
+  }
+};
+
+//! One monkey inspects its whole batch, four items per step, and splits the results between its two targets
+/*! Returns false, leaving the buffers in an unspecified state, as soon as a worry level reaches 2^48, where the
+ *  division stops being exact.
+ */
+template <op_type Op, bool Relief>
+[[nodiscard]] inline bool
+inspect_batch(std::span<u64 const> items,
+              double rhs,
+              reciprocal const &reduce,
+              divisibility const &test,
+              u64 *on_true,
+              u32 &true_size,
+              u64 *on_false,
+              u32 &false_size) noexcept {
+  // buffers are padded, so the last step may read past the batch
+  for (u32 i{0}; i < std::size(items); i += 4) {
+    u64x4 packed;
+    std::memcpy(&packed, std::data(items) + i, sizeof(packed));
+    f64x4 const worry{__builtin_convertvector(packed, f64x4)};
+    f64x4 raw;
+    if constexpr (Op == op_type::plus) {
+      raw = worry + rhs;
+    } else if constexpr (Op == op_type::multiplies) {
+      raw = worry * rhs;
+    } else {
+      raw = worry * worry;
+    }
+    i64x4 const out_of_range{raw >= reciprocal::limit};
+    f64x4 quotient, remainder;
+    reduce.divide(raw, quotient, remainder);
+    u64x4 const next{__builtin_convertvector(Relief ? quotient : remainder, u64x4)};
+    i64x4 const divisible{test.test(next)};
+    // compress-store: each item is written to both targets but only advances the one it goes to
+    u32 const lanes{std::min(4u, as<u32>(std::size(items)) - i)};
+    for (u32 l{0}; l < lanes; ++l) {
+      if (out_of_range[l]) [[unlikely]] {
+        return false;
+      }
+      bool const to_true{divisible[l] != 0};
+      on_true[true_size] = next[l];
+      on_false[false_size] = next[l];
+      true_size += to_true;
+      false_size += not to_true;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+troop::troop(std::span<monkey const> monkeys) noexcept
+    : m_size{as<u32>(std::size(monkeys))} {
+  m_monkeys.push(std::begin(monkeys), std::end(monkeys));
+  u32 total{0};
+  for (monkey const &m : monkeys) {
+    total += as<u32>(std::size(m.items()));
+  }
+  m_capacity = (total + 3) / 4 * 4 + 4;
+  m_worry.assign(m_size * m_capacity, 0);
+  for (u32 m{0}; m < m_size; ++m) {
+    std::ranges::copy(monkeys[m].items(), std::begin(m_worry) + m * m_capacity);
+    m_held[m] = as<u32>(std::size(monkeys[m].items()));
+    m_ops[m] = monkeys[m].get_op();
+    m_divisor[m] = monkeys[m].divisor();
+    m_if_true[m] = monkeys[m].target(true);
+    m_if_false[m] = monkeys[m].target(false);
+    m_modulus *= m_divisor[m];
+  }
+}
+
+template <bool Relief>
+[[nodiscard]] u64
+troop::monkey_business(u64 rounds) const noexcept {
+  std::vector<u64> worry{m_worry};
+  std::array<u32, MAX_MONKEYS> held{m_held};
+  std::array<u64, MAX_MONKEYS> inspections{};
+  reciprocal const reduce{Relief ? 3u : m_modulus};
+  std::array<divisibility, MAX_MONKEYS> tests;
+  for (u32 m{0}; m < m_size; ++m) {
+    tests[m] = divisibility{m_divisor[m]};
+  }
+
+  for (u64 round{0}; round < rounds; ++round) {
+    for (u32 m{0}; m < m_size; ++m) {
+      // monkeys never throw to themselves, so the batch is not written while it is read
+      u32 const count{std::exchange(held[m], 0u)};
+      inspections[m] += count;
+      std::span<u64 const> const items{std::data(worry) + m * m_capacity, count};
+      u64 *on_true{std::data(worry) + m_if_true[m] * m_capacity};
+      u64 *on_false{std::data(worry) + m_if_false[m] * m_capacity};
+      auto const dispatch = [&]<op_type Op>(std::integral_constant<op_type, Op>) {
+        return inspect_batch<Op, Relief>(items,
+                                  as<double>(m_ops[m].rhs()),
+                                  reduce,
+                                  tests[m],
+                                  on_true,
+                                  held[m_if_true[m]],
+                                         on_false,
+                                         held[m_if_false[m]]);
+      };
+      bool exact{true};
+      switch (m_ops[m].type()) {
+      case op_type::plus:
+        exact = dispatch(std::integral_constant<op_type, op_type::plus>{});
+        break;
+      case op_type::multiplies:
+        exact = dispatch(std::integral_constant<op_type, op_type::multiplies>{});
+        break;
+      case op_type::squares:
+        exact = dispatch(std::integral_constant<op_type, op_type::squares>{});
+        break;
+      }
+      if (not exact) {
+        // start over on the scalar simulation, which computes each worry level in 64 bits
+        return day11::monkey_business<Relief>(m_monkeys, rounds);
+      }
+    }
+  }
+
+  if (m_size < 2) {
+    return 0;
+  }
+  std::nth_element(std::begin(inspections), std::begin(inspections) + 1, std::begin(inspections) + m_size,
+                   std::greater<>{});
+  return inspections[0] * inspections[1];
+}
+
+template u64 troop::monkey_business<false>(u64) const noexcept;
+template u64 troop::monkey_business<true>(u64) const noexcept;
+
+} // namespace day11
+
+SOLVE_IMPL(Day11, Part2, monkeys, part1_answer) {
+  return day11::monkey_business<not Part2>(monkeys, Part2 ? 10'000 : 20);
+}
+
 INSTANTIATE(Day11);
 
+PARSE_IMPL(Day11Rounds, view) {
+  return day11::troop{Day11{}.parse_input(view)};
+}
+
+SOLVE_IMPL(Day11Rounds, Part2, troop, part1_answer) {
+  return troop.template monkey_business<not Part2>(Part2 ? 10'000 : 20);
+}
+
+INSTANTIATE(Day11Rounds);
+
 INSTANTIATE_TEST(Day11,
                  R"(
 Monkey 0:
@@ -117,3 +454,92 @@ Monkey 3:
 )"sv.substr(1),
                  10605LU,
                  2713310158LU)
+
+INSTANTIATE_TEST(Day11Rounds,
+                 R"(
+Monkey 0:
+  Starting items: 79, 98
+  Operation: new = old * 19
+  Test: divisible by 23
+    If true: throw to monkey 2
+    If false: throw to monkey 3
+
+Monkey 1:
+  Starting items: 54, 65, 75, 74
+  Operation: new = old + 6
+  Test: divisible by 19
+    If true: throw to monkey 2
+    If false: throw to monkey 0
+
+Monkey 2:
+  Starting items: 79, 60, 97
+  Operation: new = old * old
+  Test: divisible by 13
+    If true: throw to monkey 1
+    If false: throw to monkey 3
+
+Monkey 3:
+  Starting items: 74
+  Operation: new = old + 3
+  Test: divisible by 17
+    If true: throw to monkey 0
+    If false: throw to monkey 1
+)"sv.substr(1),
+                 10605LU,
+                 2713310158LU)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("day11 worry levels beyond 32 bits") {
+  for (u32 d : {2u, 3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u}) {
+    day11::divisibility const test{d};
+    for (u64 n : {268435456LU, 268435439LU, 2147483648LU, 4294967295LU, 281474976710655LU, 72057594037927935LU}) {
+      day11::u64x4 const lanes{n, n - 1, n / 2, 17u * (n / 17)};
+      day11::i64x4 const divisible{test.test(lanes)};
+      for (u32 l{0}; l < 4; ++l) {
+        CHECK_EQ(divisible[l] != 0, lanes[l] % d == 0);
+      }
+    }
+  }
+  // relief alone leaves worry levels of up to 62 bits here; truncating them to 32 bits would give 8190
+  std::string_view const input{R"(
+Monkey 0:
+  Starting items: 99, 98, 97
+  Operation: new = old * 19
+  Test: divisible by 2
+    If true: throw to monkey 1
+    If false: throw to monkey 2
+
+Monkey 1:
+  Starting items: 61
+  Operation: new = old * 3
+  Test: divisible by 3
+    If true: throw to monkey 0
+    If false: throw to monkey 0
+
+Monkey 2:
+  Starting items: 52, 43
+  Operation: new = old * 3
+  Test: divisible by 5
+    If true: throw to monkey 0
+    If false: throw to monkey 0
+)"sv.substr(1)};
+  // 117 and 62 inspections, from an arbitrary-precision simulation
+  CHECK_EQ(Day11{}.part1(Day11{}.parse_input(input)), 7254u);
+  CHECK_EQ(Day11Rounds{}.part1(Day11Rounds{}.parse_input(input)), 7254u);
+}
+#endif
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("day11 with a single monkey") {
+  std::string_view const input{R"(
+Monkey 0:
+  Starting items: 79, 98
+  Operation: new = old + 1
+  Test: divisible by 2
+    If true: throw to monkey 0
+    If false: throw to monkey 0
+)"sv.substr(1)};
+  CHECK_EQ(Day11{}.part1(Day11{}.parse_input(input)), 0u);
+  CHECK_EQ(Day11Rounds{}.part2(Day11Rounds{}.parse_input(input), 0u), 0u);
+}
+#endif
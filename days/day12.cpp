@@ -1,101 +1,84 @@
-#include "days/day12.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <span>
+#include <vector>
 
-PARSE_IMPL(Day12, view) {
-  u32 const width = as<u32>(view.find_first_of('\n') + 1);
-  u32 const height = as<u32>(view.size() / width);
-  u32 const start = as<u32>(view.find_first_of('S'));
-  u32 const stop = as<u32>(view.find_first_of('E', start));
-  owning_span<char, day12::MAX_SIZE> grid;
-  grid.push(std::begin(view), std::end(view));
-  grid[start] = 'a';
-  grid[stop] = 'z';
-  return {grid, start, stop, width, height};
-}
+#include "days/day12.hpp"
 
 namespace {
 
-struct pair {
-  u32 distance{0};
-  u32 index{0};
-};
-
-u32 part2_answer{-1u};
-
-[[gnu::always_inline]] inline void
-enqueue(auto &queued, auto &grid, auto &back, u32 curr, u32 next, u32 dist) noexcept {
-  // only enqueue if not seen and we can move there
-  if (not queued[next] and (grid[curr] - grid[next]) <= 1) {
-    // mark as queued/seen
-    queued[next] = 1;
-    // push back
-    *back++ = {dist, next};
-  }
+[[nodiscard]] constexpr inline char
+elevation(char c) noexcept {
+  return (c == 'S') ? 'a' : ((c == 'E') ? 'z' : c);
 }
 
 } // namespace
 
-SOLVE_IMPL(Day12, Part2, data, part1_answer) {
-
-  if constexpr (Part2) {
-    return part2_answer;
-  }
-
-  auto const &grid{data.grid};
-  u32 const stop{data.stop};
-  u32 const start{data.start};
-  u32 const width{data.width};
-
-  // single memory allocation for queued + frontier
-  owning_span<u8, day12::MAX_SIZE> queued;
-  owning_span<pair, day12::MAX_SIZE> frontier;
-
-  // initialize queue
-  queued.resize(std::size(grid));
-  std::fill(std::begin(queued), std::end(queued), 0);
-
-  // model a queue as two pointers
-  pair const *front = std::data(frontier);
-  pair *back = std::data(frontier);
-
-  // start from the end -- work back toward
-  *back++ = {0u, stop};
+PARSE_IMPL(Day12, view) {
+  day12::height_map map{std::string{view},
+                        as<u32>(view.find_first_of('\n') + 1),
+                        as<u32>(view.find('S')),
+                        as<u32>(view.find('E')),
+                        grid_search::engine<>{as<u32>(std::size(view))}};
+  map.cells[map.start] = 'a';
+  map.cells[map.summit] = 'z';
+  return map;
+}
 
-  while (front != back) {
-    // pop front
-    auto [dist, curr] = *front++;
-    if (grid[curr] == 'a') {
-      part2_answer = std::min(part2_answer, dist);
-      if (curr == start) {
-        return dist;
+SOLVE_IMPL(Day12, Part2, map, part1_answer) {
+  auto const &cells = map.cells;
+  u32 const size{as<u32>(std::size(cells))}, stride{map.stride};
+  // walk back down from the summit: a step may drop at most one level and climb any amount
+  auto const neighbors = [&](u32 curr, auto &&emit) noexcept {
+    auto const visit = [&](u32 next) noexcept {
+      if (next < size and cells[next] != '\n' and cells[curr] - cells[next] <= 1) {
+        emit(next);
       }
-    }
-    // walk one step
-    ++dist;
+    };
+    // an index below zero wraps past the end
+    visit(curr - 1);
+    visit(curr + 1);
+    visit(curr - stride);
+    visit(curr + stride);
+  };
+  auto const goal = [&](u32 node) noexcept {
+    return Part2 ? cells[node] == 'a' : node == map.start;
+  };
+  u32 const summit[]{map.summit};
+  return map.search.run(summit, neighbors, goal).value_or(-1u);
+}
 
-    // left -- check detects overflow for first row or looks for newline
-    if (u32 const next{curr - 1}; next < curr and grid[next] != '\n') {
-      enqueue(queued, grid, back, curr, next, dist);
-    }
-    // right -- check looks for newline to right
-    if (u32 const next{curr + 1}; grid[next] != '\n') {
-      enqueue(queued, grid, back, curr, next, dist);
-    }
-    // up -- check detects overflow
-    if (curr > width) {
-      if (u32 const next{curr - width}; next < curr) {
-        enqueue(queued, grid, back, curr, next, dist);
+INSTANTIATE(Day12);
+
+PARSE_IMPL(Day12Bitsets, view) {
+  u32 const width = as<u32>(view.find_first_of('\n'));
+  u32 const stride{width + 1};
+  u32 const height = as<u32>((std::size(view) + 1) / stride);
+  std::vector<char> heights(std::size(view));
+  std::transform(std::begin(view), std::end(view), std::begin(heights), elevation);
+  bitset_bfs climb{std::span<char const>{heights}, width, height, stride, [](char from, char to) {
+                     return to <= from + 1;
+                   }};
+  day12::terrain terrain{climb, climb.make_set(), climb.make_set(), climb.make_set()};
+  usize const start{view.find('S')}, summit{view.find('E')};
+  terrain.start.set(as<u32>(start % stride), as<u32>(start / stride));
+  terrain.summit.set(as<u32>(summit % stride), as<u32>(summit / stride));
+  for (u32 y{0}; y < height; ++y) {
+    for (u32 x{0}; x < width; ++x) {
+      if (heights[y * stride + x] == 'a') {
+        terrain.lowest.set(x, y);
       }
     }
-    // down -- checks boundary/size
-    if (u32 const next{curr + width}; next < std::size(grid)) {
-      enqueue(queued, grid, back, curr, next, dist);
-    }
   }
+  return terrain;
+}
 
-  return -1u;
+SOLVE_IMPL(Day12Bitsets, Part2, terrain, part1_answer) {
+  // every lowest square is a source at once for part 2
+  return terrain.climb.distance(Part2 ? terrain.lowest : terrain.start, terrain.summit).value_or(-1u);
 }
 
-INSTANTIATE(Day12);
+INSTANTIATE(Day12Bitsets);
 
 INSTANTIATE_TEST(Day12,
                  R"(
@@ -107,3 +90,55 @@ abdefghi
 )"sv.substr(1),
                  31u,
                  29u)
+
+INSTANTIATE_TEST(Day12Bitsets,
+                 R"(
+Sabqponm
+abcryxxl
+accszExk
+acctuvwj
+abdefghi
+)"sv.substr(1),
+                 31u,
+                 29u)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("grid_search::engine with weighted steps") {
+  // entering a square costs its digit
+  std::string_view const risk{"1163751\n1381373\n2136511\n3694931\n7463417\n"};
+  u32 const size{as<u32>(std::size(risk))}, stride{8}, target{size - 2};
+  auto const neighbors = [&](u32 curr, auto &&emit) noexcept {
+    for (u32 next : {curr - 1, curr + 1, curr - stride, curr + stride}) {
+      if (next < size and risk[next] != '\n') {
+        emit(next, as<u32>(risk[next] - '0'));
+      }
+    }
+  };
+  auto const goal = [&](u32 node) noexcept {
+    return node == target;
+  };
+  auto const manhattan = [&](u32 node) noexcept {
+    return as<u32>(std::abs(as<i32>(target % stride) - as<i32>(node % stride)) +
+                   std::abs(as<i32>(target / stride) - as<i32>(node / stride)));
+  };
+  u32 const source[]{0};
+  CHECK_EQ(grid_search::engine<9>{size}.run(source, neighbors, goal).value_or(0u), 28u);
+  CHECK_EQ(grid_search::engine<9>{size}.run(source, neighbors, goal, manhattan).value_or(0u), 28u);
+  // an engine can be run again
+  grid_search::engine<9> reused{size};
+  CHECK_EQ(reused.run(source, neighbors, goal, manhattan).value_or(0u), 28u);
+  CHECK_EQ(reused.run(source, neighbors, goal).value_or(0u), 28u);
+  grid_search::engine<> unit{size};
+  auto const walk = [&](u32 curr, auto &&emit) noexcept {
+    neighbors(curr, [&](u32 next, u32) noexcept {
+      emit(next);
+    });
+  };
+  CHECK_EQ(unit.run(source, walk, goal).value_or(0u), 10u);
+  CHECK_EQ(unit.run(source, walk, goal).value_or(0u), 10u);
+  // sources whose heuristics lie further apart than the initial bucket ring
+  u32 const far_apart[]{0, target - 2};
+  CHECK_EQ(unit.run(far_apart, walk, goal, manhattan).value_or(0u), 2u);
+  CHECK_EQ(grid_search::engine<9>{size}.run(far_apart, neighbors, goal, manhattan).value_or(0u), 8u);
+}
+#endif
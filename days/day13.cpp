@@ -1,180 +1,185 @@
 #include <algorithm>
-#include <type_traits>
+#include <cstdio>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "days/day13.hpp"
 
-namespace day13 {
+namespace {
+
+// tokens are big-endian u16s, so comparing keys bytewise compares their tokens in order
+constexpr usize const token_size{2};
 
-// handle
-// ============================================================================
+// a list ends before anything else; a list starting (at any depth) with an empty list is below every number
+constexpr u16 const close{0};
+constexpr u16 const open_empty{1};
 
-constexpr inline typename handle::type
-handle::get_value() const noexcept {
-  return value;
+// n sorts before a list whose first number is f exactly when n <= f, since the list then holds more after f
+[[nodiscard]] constexpr inline u16
+number(u32 n) noexcept {
+  return as<u16>(2 * n + 2);
 }
 
-constexpr inline std::span<handle const>
-handle::get_list() const noexcept {
-  // handle refers to internal heap location
-  if (value < 0) {
-    // starting is the data pointer plus the offset (subtract since negated)
-    handle const *start{handle::data - value};
-    // calculate the length of the list
-    u32 len{0};
-    while (start[len] != Null) {
-      ++len;
-    }
-    // return the span of handles
-    return std::span{start, len};
-  } else {
-    // transform number into list
-    return std::span{std::addressof(*this), 1};
+[[nodiscard]] constexpr inline u16
+open(u32 first) noexcept {
+  return as<u16>(2 * first + 3);
+}
+
+inline void
+put(char *out, u16 token) noexcept {
+  out[0] = as<char>(token >> 8);
+  out[1] = as<char>(token & 0xFF);
+}
+
+[[nodiscard]] constexpr inline u32
+value(char const *&in) noexcept {
+  u32 n{0};
+  while (*in >= '0' and *in <= '9') {
+    n = std::min(10 * n + as<u32>(*in++ - '0'), day13::packets::max_number + 1);
   }
+  return n;
 }
 
-constexpr inline std::partial_ordering
-handle::operator<=>(handle const &b) const noexcept {
-  if (i32 const av{value}, bv{b.value}; av >= 0 and bv >= 0) {
-    // we have a number
-    if (av < bv) {
-      return std::partial_ordering::less;
-    } else if (av > bv) {
-      return std::partial_ordering::greater;
-    } else {
-      return std::partial_ordering::unordered;
+//! Writes packet keys, two bytes per character of the packet at most
+class encoder {
+  struct open_list {
+    // where the list's opening token was written
+    usize start;
+    u32 elements;
+    // whether the latest element was keyed as a lone number
+    bool lone_number;
+  };
+
+  // lists enclosing the innermost open one
+  std::vector<open_list> m_outer;
+  bool m_out_of_range{false};
+
+  //! fills the `pending` opening tokens just before out
+  static void settle(char *out, usize pending, u16 token) noexcept {
+    for (char *at{out - pending * token_size}; at != out; at += token_size) {
+      put(at, token);
     }
-  } else {
-    // have at least one list
-    std::span const sa{get_list()};
-    std::span const sb{b.get_list()};
-    auto A = std::begin(sa);
-    auto B = std::begin(sb);
+  }
+
+public:
+  //! whether any number keyed so far exceeded packets::max_number
+  [[nodiscard]] inline bool out_of_range() const noexcept {
+    return m_out_of_range;
+  }
+
+  //! keys the packet at `in` into `out`; returns the ends of the packet and of its key
+  [[nodiscard]] std::pair<char const *, char *> packet(char const *in, char *out) noexcept {
+    char *const base{out};
+    // the packet itself is a list the whole key belongs to, so it needs no opening
+    open_list list{0, 0, false};
+    // openings written since the last number or closing; they learn their first number from whatever comes next
+    usize pending{0};
+    ++in;
     while (true) {
-      bool const a_good{A != std::end(sa)};
-      bool const b_good{B != std::end(sb)};
-      // check if we have more elements in both lists
-      if (not a_good or not b_good) {
-        if (b_good) {
-          return std::partial_ordering::less;
-        } else if (a_good) {
-          return std::partial_ordering::greater;
+      // an element starts here, unless a list just opened is empty
+      if (*in == '[') {
+        m_outer.push_back(list);
+        list = {as<usize>(out - base), 0, false};
+        out += token_size;
+        ++pending;
+        ++in;
+        continue;
+      }
+      if (*in != ']') {
+        u32 const n{value(in)};
+        m_out_of_range |= (n > day13::packets::max_number);
+        settle(out, pending, open(n));
+        pending = 0;
+        put(out, number(n));
+        out += token_size;
+        ++list.elements;
+        list.lone_number = true;
+      }
+      // closings up to the comma before the next element
+      while (*in == ']') {
+        ++in;
+        settle(out, pending, open_empty);
+        pending = 0;
+        if (m_outer.empty()) {
+          put(out, close);
+          return {in, out + token_size};
+        }
+        bool const lone_number{list.elements == 1 and list.lone_number};
+        if (lone_number) {
+          // [n] compares equal to n wherever it appears
+          out = base + list.start;
+          std::copy_n(out + token_size, token_size, out);
         } else {
-          return std::partial_ordering::unordered;
+          put(out, close);
         }
+        out += token_size;
+        list = m_outer.back();
+        m_outer.pop_back();
+        ++list.elements;
+        list.lone_number = lone_number;
       }
-      // look at the next pair of values
-      auto const res = (*A <=> *B);
-      // if we are less or greater, early exit!
-      if (res != std::partial_ordering::unordered) {
-        return res;
-      }
-      ++A;
-      ++B;
+      ++in; // expect ','
     }
   }
-}
+};
 
-// structure
-// ============================================================================
-
-constexpr inline structure::structure(std::string_view buffer) noexcept
-    : ptr{std::begin(buffer)},
-      end{std::end(buffer)} {
-  while (ptr < end) {
-    raw_elems[num_elems++] = List();
-    ++ptr; // expect '\n';
-    raw_elems[num_elems++] = List();
-    ++ptr; // expect '\n';
-    ++ptr; // expect '\n';
-  }
-}
-
-constexpr inline std::span<handle const>
-structure::trials() const noexcept {
-  return {std::data(raw_elems), num_elems};
-}
+} // namespace
 
-constexpr inline handle const *
-structure::data() const noexcept {
-  return std::data(heap);
-}
+namespace day13 {
 
-// parsing
-// ============================================================================
-
-// List := '[' (Elem [',' Elem ]* )? ']'
-constexpr inline handle
-structure::List() noexcept {
-  using type = typename handle::type;
-  ++ptr; // expect '['
-  std::array<handle, MAX_LEN> elems;
-  std::make_unsigned_t<type> count{0};
-  if (*ptr != ']') {
-    elems[count++] = Elem();
-    while (*ptr != ']') {
-      ++ptr; // expect ','
-      elems[count++] = Elem();
+packets::packets(std::string_view input) noexcept {
+  // no packet's key takes more than a token per character
+  m_keys.resize(token_size * std::size(input));
+  char *out{std::data(m_keys)};
+  encoder keys;
+  for (char const *in{std::data(input)}, *const end{in + std::size(input)}; in != end;) {
+    if (*in == '\n') {
+      ++in;
+      continue;
     }
+    std::tie(in, out) = keys.packet(in, out);
+    m_ends.push_back(as<u32>(out - std::data(m_keys)));
   }
-  // add null terminator to list
-  elems[count++] = Null;
-  ++ptr; // expect ']'
-  // copy list elements to list location in "heap"
-  std::move(std::begin(elems), std::begin(elems) + count, std::begin(heap) + brk);
-  // return location of list
-  i16 const result{as<i16>(-brk)};
-  brk = as<type>(brk + as<type>(count));
-  return result;
+  if (keys.out_of_range()) {
+    (void)fprintf(stderr, "Day 13 packet numbers must not exceed %u\n", max_number);
+    m_keys.clear();
+    m_ends.clear();
+    return;
+  }
+  m_keys.resize(as<usize>(out - std::data(m_keys)));
 }
 
-// Elem := List | [0-9][0-9]?
-constexpr inline handle
-structure::Elem() noexcept {
-  using type = typename handle::type;
-  if (*ptr == '[') {
-    // list
-    return List();
-  } else if (type const val(as<type>(*ptr++ - '0')); *ptr >= '0' and *ptr <= '9') {
-    // two digit number
-    return {as<type>((val * 10) + (*ptr++ - '0'))};
-  } else {
-    // single digit
-    return handle{val};
-  }
+std::string
+packets::key(std::string_view packet) noexcept {
+  std::string result(token_size * std::size(packet), '\0');
+  auto const [in, out] = encoder{}.packet(std::data(packet), std::data(result));
+  result.resize(as<usize>(out - std::data(result)));
+  return result;
 }
 
 } // namespace day13
 
-// solution
-// ============================================================================
-
 PARSE_IMPL(Day13, view) {
-  return {view};
+  return day13::packets{view};
 }
 
-template <day13::handle H>
-bool
-cmp(day13::handle const &v) noexcept {
-  return v < H;
-}
-
-SOLVE_IMPL(Day13, Part2, data, part1_answer) {
-  // point the static data handle to the correct place
-  day13::handle::set_data(data.data());
-
-  std::span const all{data.trials()};
-
+SOLVE_IMPL(Day13, Part2, packets, part1_answer) {
   if constexpr (Part2) {
-    i64 const two = 1L + std::count_if(std::begin(all), std::end(all), cmp<2>);
-    i64 const six = 2L + std::count_if(std::begin(all), std::end(all), cmp<6>);
+    // positions once sorted are one past the number of packets below each divider; [[2]] also sits below [[6]]
+    std::string const two_key{day13::packets::key("[[2]]")}, six_key{day13::packets::key("[[6]]")};
+    i64 two{1}, six{2};
+    for (usize i{0}; i < std::size(packets); ++i) {
+      two += (packets[i] < two_key);
+      six += (packets[i] < six_key);
+    }
     return two * six;
   } else {
-    i64 result{0}, trial{1};
-    for (u32 idx{0}; idx < std::size(all); idx += 2) {
-      if (all[idx] < all[idx + 1]) {
-        result += trial;
+    i64 result{0};
+    for (usize i{0}; i + 1 < std::size(packets); i += 2) {
+      if (packets[i] < packets[i + 1]) {
+        result += as<i64>(i / 2 + 1);
       }
-      ++trial;
     }
     return result;
   }
@@ -210,3 +215,16 @@ INSTANTIATE_TEST(Day13,
 )"sv.substr(1),
                  13,
                  140)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("day13 packet numbers past a byte") {
+  std::string_view const input{"[127]\n[[126,9]]\n\n[300,1]\n[[300],0]\n\n[[]]\n[32766]\n"sv};
+  day13::packets const packets{input};
+  CHECK_EQ(packets.size(), 6u);
+  // 127 > 126; [300,1] > [[300],0]; [[]] < [32766]
+  CHECK_EQ(packets[0] < packets[1], false);
+  CHECK_EQ(packets[2] < packets[3], false);
+  CHECK_EQ(packets[4] < packets[5], true);
+  CHECK_EQ(day13::packets{"[32767]\n"sv}.size(), 0u);
+}
+#endif
@@ -1,132 +1,127 @@
 #include <algorithm>
+#include <bit>
+#include <utility>
 
 #include "days/day14.hpp"
-#include "owning_span.hpp"
-#include "point2d.hpp"
 
-PARSE_IMPL(Day14, view) {
-  owning_span<point2d, day14::MAX_POINTS> points;
+namespace day14 {
+
+cave::cave(i32 floor) noexcept
+    : m_floor{floor},
+      m_left{source_x - (floor - 1)},
+      m_row_words{(as<u32>(2 * floor - 1) + 63) / 64},
+      m_bits(as<usize>(floor) * m_row_words, 0LU) {
+}
+
+void
+cave::add_rock(point2d from, point2d to) noexcept {
+  i32 const right{source_x + (m_floor - 1)};
+  if (from.y == to.y) {
+    i32 const lo{std::max(std::min(from.x, to.x), m_left)}, hi{std::min(std::max(from.x, to.x), right)};
+    if (lo > hi) {
+      return;
+    }
+    // a horizontal line is a run of bits within one row, OR-ed in a word at a time
+    u64 *const words{std::data(m_bits) + as<u32>(from.y) * m_row_words};
+    for (u32 bit{column(lo)}, last{column(hi)}; bit <= last;) {
+      u32 const count{std::min(64 - bit % 64, last - bit + 1)};
+      words[bit / 64] |= (~0LU >> (64 - count)) << (bit % 64);
+      bit += count;
+    }
+  } else if (from.x >= m_left and from.x <= right) {
+    for (i32 y{std::min(from.y, to.y)}; y <= std::max(from.y, to.y); ++y) {
+      set(from.x, y);
+    }
+  }
+}
 
-  // drop point location is set as the bounds
-  i32 xmin{500}, xmax{500}, ymin{0}, ymax{0};
+} // namespace day14
 
+PARSE_IMPL(Day14, view) {
+  std::vector<std::pair<point2d, point2d>> lines;
+  // the floor is only known after every line is read
+  lines.reserve(std::size(view) / 8);
+  i32 lowest{0};
   u32 off{0};
+  bool continues{false};
+  point2d prev;
   while (off < std::size(view)) {
     i32 x{view[off++] - '0'};
     while (view[off] != ',') {
       x = x * 10 + (view[off++] - '0');
     }
-    xmin = std::min(xmin, x);
-    xmax = std::max(xmax, x);
     ++off;
     i32 y{view[off++] - '0'};
     while (view[off] != ' ' and view[off] != '\n') {
       y = y * 10 + (view[off++] - '0');
     }
-    ymin = std::min(ymin, y);
-    ymax = std::max(ymax, y);
-    points.push({x, y});
-    if (view[off] == ' ') {
-      off += 4;
-    } else {
-      points.push({0, 0});
-      ++off;
+    lowest = std::max(lowest, y);
+    point2d const curr{x, y};
+    if (continues) {
+      lines.emplace_back(prev, curr);
     }
+    prev = curr;
+    continues = (view[off] == ' ');
+    off += continues ? 4 : 1;
   }
 
-  day14::cave_type cave{xmin - 1, xmax + 1, ymin, ymax + 2};
-  std::fill(std::begin(cave), std::end(cave), '.');
-
-  point2d prev{points[0]};
-  for (u32 idx{1}; idx < std::size(points); ++idx) {
-    point2d const dest{points[idx]};
-    if (prev.x == dest.x or prev.y == dest.y) {
-      for (point2d const delta{(dest - prev).sgn()}; prev != dest; prev += delta) {
-        cave(prev) = '#';
-      }
-      cave(dest) = '#';
-    }
-    prev = dest;
+  day14::cave cave{lowest + 2};
+  for (auto const &[from, to] : lines) {
+    cave.add_rock(from, to);
   }
   return cave;
 }
 
-using path_t = owning_span<point2d, day14::MAX_HEIGHT>;
-
-constexpr inline bool
-drop(day14::cave_type &cave, path_t &path) noexcept {
-  if (path.size() == 0) {
-    return false;
-  }
-  while (true) {
-    auto const [x, y] = path.top();
-    if (y >= cave.ymax() - 1) {
-      return false;
-    } else if (cave(x, y + 1) == '.') {
-      path.push({x, y + 1});
-    } else if (cave(x - 1, y + 1) == '.') {
-      path.push({x - 1, y + 1});
-    } else if (cave(x + 1, y + 1) == '.') {
-      path.push({x + 1, y + 1});
-    } else {
-      cave(x, y) = 'o';
-      path.pop();
-      return true;
-    }
-  }
-}
-
-PART1_IMPL(Day14, data) {
-
-  auto cave{data};
+PART1_IMPL(Day14, rock) {
+  auto cave{rock};
+  // sand below the lowest rock falls forever
+  i32 const abyss{cave.floor() - 1};
 
-  path_t path;
-  path.push({500, 0});
+  // column of the falling grain in every row it passed through; the next grain retraces it from the last open spot
+  std::vector<i32> path{day14::source_x};
+  path.reserve(as<usize>(abyss) + 1);
 
   u32 placed{0};
-  while (drop(cave, path)) {
-    ++placed;
+  while (not path.empty()) {
+    i32 const x{path.back()};
+    i32 const y{as<i32>(std::size(path)) - 1};
+    if (y == abyss) {
+      break;
+    }
+    if (not cave.test(x, y + 1)) {
+      path.push_back(x);
+    } else if (not cave.test(x - 1, y + 1)) {
+      path.push_back(x - 1);
+    } else if (not cave.test(x + 1, y + 1)) {
+      path.push_back(x + 1);
+    } else {
+      cave.set(x, y);
+      path.pop_back();
+      ++placed;
+    }
   }
-
   return placed;
 }
 
-PART2_IMPL(Day14, data, part1_answer) {
+PART2_IMPL(Day14, cave, part1_answer) {
+  // sand rests on every square reachable diagonally or straight down from the source that is not rock, so each row
+  // is the previous one spread a column each way, less the rock
+  u32 const words{cave.row_words()};
+  std::vector<u64> prev(words, 0LU), next(words, 0LU);
+  u32 const source{as<u32>(cave.floor() - 1)};
+  prev[source / 64] = 1LU << (source % 64);
   u32 placed{1};
-
-  auto cave{data};
-  cave(500, 0) = 'o';
-
-  auto const xmin = cave.xmin();
-  auto const xmax = cave.xmax();
-  auto const ymax = cave.ymax();
-
-  for (i32 y{1}; y < ymax; ++y) {
-    // left edge
-    if (cave(xmin, y) == '.' and (cave(xmin, y - 1) == 'o' or cave(xmin + 1, y - 1) == 'o')) {
-      ++placed;
-      cave(xmin, y) = 'o';
-    }
-    // middle
-    for (i32 x{xmin + 1}; x < xmax; ++x) {
-      if (cave(x, y) == '.' and (cave(x - 1, y - 1) == 'o' or cave(x, y - 1) == 'o' or cave(x + 1, y - 1) == 'o')) {
-        ++placed;
-        cave(x, y) = 'o';
-      }
-    }
-    // right edge
-    if (cave(xmax, y) == '.' and (cave(xmax - 1, y - 1) == 'o' or cave(xmax, y - 1) == 'o')) {
-      ++placed;
-      cave(xmax, y) = 'o';
+  for (i32 y{1}; y < cave.floor(); ++y) {
+    auto const rock = cave.row(y);
+    for (u32 i{0}; i < words; ++i) {
+      u64 const from_lower{i > 0 ? prev[i - 1] >> 63 : 0LU};
+      u64 const from_higher{i + 1 < words ? prev[i + 1] << 63 : 0LU};
+      next[i] = (prev[i] | (prev[i] << 1) | from_lower | (prev[i] >> 1) | from_higher) & ~rock[i];
+      placed += as<u32>(std::popcount(next[i]));
     }
+    std::swap(prev, next);
   }
-
-  auto const left = ymax - (501 - xmin);
-  auto const right = ymax - (xmax - 499);
-  auto const left_tri = (left * (left + 1) / 2);
-  auto const right_tri = (right * (right + 1) / 2);
-
-  return placed + as<u32>(left_tri + right_tri);
+  return placed;
 }
 
 INSTANTIATE_TEST(Day14,
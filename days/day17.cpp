@@ -1,16 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 #include "days/day17.hpp"
 #include "parsing.hpp"
 
+namespace {
+
+// each rock is four rows packed into a u32 (byte 0 is the bottom row); bit 6 of a row is the leftmost column and
+// every rock starts two columns from the left wall
+constexpr std::array<u32, 5> const rocks{0x0000001Eu, 0x00081C08u, 0x0004041Cu, 0x10101010u, 0x00001818u};
+constexpr std::array<u32, 5> const rock_heights{1u, 3u, 3u, 4u, 2u};
+
+constexpr u32 const left_wall{0x40404040u};
+constexpr u32 const right_wall{0x01010101u};
+
+[[nodiscard]] constexpr inline u32
+push(u32 rock, char jet) noexcept {
+  if (jet == '<') {
+    return (rock & left_wall) ? rock : rock << 1;
+  } else {
+    return (rock & right_wall) ? rock : rock >> 1;
+  }
+}
+
+//! every rock's position after the four wall-only pushes, indexed by rock and the four jets (bit set = push right)
+constexpr std::array<std::array<u32, 16>, 5> const opening_moves{[] {
+  std::array<std::array<u32, 16>, 5> result{};
+  for (u32 r{0}; r < 5; ++r) {
+    for (u32 pattern{0}; pattern < 16; ++pattern) {
+      u32 rock{rocks[r]};
+      for (u32 i{0}; i < 4; ++i) {
+        rock = push(rock, ((pattern >> i) & 1) ? '>' : '<');
+      }
+      result[r][pattern] = rock;
+    }
+  }
+  return result;
+}()};
+
+//! 7-wide tower stored one u8 per row; old rows are discarded so the simulation never runs out of space
+class chamber {
+  constexpr static u32 const capacity{1u << 12};
+  constexpr static u32 const keep{1u << 10};
+
+  // padding keeps four-row window loads at the top in bounds
+  std::array<u8, capacity + 8> rows{};
+  u64 discarded{0};
+  u32 top{0};
+
+  [[nodiscard]] inline u32 window(u32 y) const noexcept {
+    u32 w;
+    std::memcpy(&w, std::data(rows) + y, sizeof(w));
+    return w;
+  }
+
+public:
+  [[nodiscard]] inline u64 height() const noexcept {
+    return discarded + top;
+  }
+
+  inline void drop(u32 rock_index, std::string_view jets, u32 &jet) noexcept {
+    u32 const num_jets{as<u32>(std::size(jets))};
+    auto const next_jet = [&] {
+      char const c{jets[jet]};
+      jet = (jet + 1 == num_jets) ? 0 : jet + 1;
+      return c;
+    };
+    // the first four pushes happen above the tower where only the walls matter
+    u32 pattern{0};
+    for (u32 i{0}; i < 4; ++i) {
+      pattern |= as<u32>(next_jet() == '>') << i;
+    }
+    u32 rock{opening_moves[rock_index][pattern]};
+    u32 y{top};
+    while (y > 0 and not(rock & window(y - 1))) {
+      --y;
+      if (u32 const shifted{push(rock, next_jet())}; not(shifted & window(y))) {
+        rock = shifted;
+      }
+    }
+    u32 const settled{window(y) | rock};
+    std::memcpy(std::data(rows) + y, &settled, sizeof(settled));
+    top = std::max(top, y + rock_heights[rock_index]);
+    if (top + 8 > capacity) {
+      u32 const shift{top - keep};
+      std::memmove(std::data(rows), std::data(rows) + shift, keep);
+      std::fill(std::begin(rows) + keep, std::end(rows), u8{0});
+      top -= shift;
+      discarded += shift;
+    }
+  }
+
+  //! hash of the top 32 rows, which stands in for the reachable surface
+  [[nodiscard]] inline u64 profile() const noexcept {
+    u64 hash{0};
+    for (u32 i{1}; i <= 4; ++i) {
+      u64 word{0};
+      if (top >= 8 * i) {
+        std::memcpy(&word, std::data(rows) + top - 8 * i, sizeof(word));
+      }
+      hash = (hash ^ word) * 0x9E3779B97F4A7C15LU;
+      hash ^= hash >> 29;
+    }
+    return hash;
+  }
+};
+
+struct cycle_entry {
+  u64 key{0};
+  u64 rocks{0};
+  u64 height{0};
+};
+
+//! Open-addressed (jet index, surface profile) -> (rocks dropped, height) table, probed every fifth rock
+class cycle_table {
+  constexpr static u32 const capacity{1u << 11};
+  constexpr static u32 const mask{capacity - 1};
+
+  std::array<cycle_entry, capacity> entries{};
+  u32 used{0};
+
+public:
+  //! Returns the earlier entry with the same key, otherwise records this one and returns nullptr
+  [[nodiscard]] inline cycle_entry const *find_or_insert(u64 key, u64 rocks_dropped, u64 height) noexcept {
+    // zero marks an empty slot
+    key |= 1;
+    u32 idx{as<u32>(key >> 40) & mask};
+    while (entries[idx].key != 0) {
+      if (entries[idx].key == key) {
+        return &entries[idx];
+      }
+      idx = (idx + 1) & mask;
+    }
+    entries[idx] = cycle_entry{key, rocks_dropped, height};
+    if (++used > capacity / 2) {
+      // forgetting history only delays detection
+      entries.fill(cycle_entry{});
+      used = 0;
+    }
+    return nullptr;
+  }
+};
+
+[[nodiscard]] u64
+height_after(std::string_view jets, u64 total) noexcept {
+  chamber tower;
+  cycle_table seen;
+  u32 jet{0};
+  u64 skipped_height{0};
+  u32 rock_index{0};
+  for (u64 n{0}; n < total; ++n, rock_index = (rock_index == 4) ? 0 : rock_index + 1) {
+    if (rock_index == 0 and skipped_height == 0) {
+      u64 const key{(tower.profile() ^ jet) * 0xD6E8FEB86659FD93LU};
+      if (auto const *prev = seen.find_or_insert(key, n, tower.height()); prev != nullptr) {
+        u64 const period{n - prev->rocks};
+        u64 const cycles{(total - n) / period};
+        skipped_height = cycles * (tower.height() - prev->height);
+        n += cycles * period;
+        if (n == total) {
+          break;
+        }
+      }
+    }
+    tower.drop(rock_index, jets, jet);
+  }
+  return tower.height() + skipped_height;
+}
+
+} // namespace
+
 PARSE_IMPL(Day17, view) {
-  return view.substr(0, std::size(view) - 1);
+  while (not view.empty() and view.back() == '\n') {
+    view.remove_suffix(1);
+  }
+  return view;
 }
 
 PART1_IMPL(Day17, jets) {
-  return {};
+  return height_after(jets, 2022);
 }
 
 PART2_IMPL(Day17, jets, part1_answer) {
-  return {};
+  return height_after(jets, 1'000'000'000'000LU);
 }
 
 INSTANTIATE_TEST(Day17,
@@ -1,107 +1,126 @@
+#include <algorithm>
+#include <array>
+
 #include "days/day18.hpp"
-#include "owning_span.hpp"
 #include "parsing.hpp"
 
 namespace {
 
-constexpr inline u32
-index(i32 x, i32 y, i32 z) noexcept {
-  using day18::MAX_DIM;
-  return MAX_DIM * MAX_DIM * as<u32>(z) + MAX_DIM * as<u32>(y) + as<u32>(x);
-}
+using day18::voxel;
 
-constexpr inline u32
-pack(i32 x, i32 y, i32 z) noexcept {
-  return as<u32>((x << 16) | (y << 8) | z);
+//! index offsets of the six face neighbors
+[[nodiscard]] constexpr inline std::array<u32, 6>
+face_steps(day18::droplet const &drop) noexcept {
+  u32 const row{drop.width}, plane{drop.width * drop.depth};
+  // subtraction is addition modulo 2^32
+  return {-1u, 1u, -row, row, -plane, plane};
 }
 
-constexpr inline auto
-unpack(u32 v) noexcept {
-  return std::tuple(as<i32>((v >> 16) & 0xFF), as<i32>((v >> 8) & 0xFF), as<i32>(v & 0xFF));
+//! a voxel just inside the air shell
+[[nodiscard]] constexpr inline u32
+corner(day18::droplet const &drop) noexcept {
+  return drop.index(1, 1, 1);
 }
 
-constexpr auto const DELTAS = std::array{std::array{-1, 0, 0},
-                                         std::array{1, 0, 0},
-                                         std::array{0, -1, 0},
-                                         std::array{0, 1, 0},
-                                         std::array{0, 0, -1},
-                                         std::array{0, 0, 1}};
-
 } // namespace
 
 PARSE_IMPL(Day18, view) {
-  using day18::MAX_DIM;
-  day18::grid_type grid(MAX_DIM * MAX_DIM * MAX_DIM, 0u);
+  std::vector<std::array<u32, 3>> cubes;
+  std::array<u32, 3> extent{0, 0, 0};
   for (usize off{0}; off < std::size(view);) {
-    i32 x, y, z;
+    u32 x, y, z;
     off += parse<"\0,\1,\2\n">(view.substr(off), x, y, z);
-    // offset placement by 1 in each dimension
-    grid[index(x + 1, y + 1, z + 1)] = 1u;
+    cubes.push_back({x, y, z});
+    extent = {std::max(extent[0], x), std::max(extent[1], y), std::max(extent[2], z)};
+  }
+  // lava sits at [2, max + 2] on every axis: air at 1 and max + 3, guards at 0 and max + 4
+  day18::droplet drop{extent[0] + 5, extent[1] + 5, extent[2] + 5, {}, {}};
+  drop.voxels.assign(drop.width * drop.depth * drop.height, day18::guard);
+  drop.flood = grid_search::engine<>{as<u32>(std::size(drop.voxels))};
+  for (u32 z{1}; z + 1 < drop.height; ++z) {
+    for (u32 y{1}; y + 1 < drop.depth; ++y) {
+      u32 const row{drop.index(0, y, z)};
+      std::fill_n(std::begin(drop.voxels) + row + 1, drop.width - 2, day18::air);
+    }
   }
-  return grid;
+  for (auto [x, y, z] : cubes) {
+    drop.voxels[drop.index(x + 2, y + 2, z + 2)] = day18::lava;
+  }
+  return drop;
 }
 
-PART1_IMPL(Day18, grid) {
-  using day18::MAX_DIM;
-  constexpr i32 const lower{1};
-  constexpr i32 const limit{as<i32>(MAX_DIM) - 1};
-
-  u32 voxels{0}, shared{0};
-
-  for (i32 z{lower}; z < limit; ++z) {
-    for (i32 y{lower}; y < limit; ++y) {
-      for (i32 x{lower}; x < limit; ++x) {
-        if (grid[index(x, y, z)]) {
-          ++voxels;
-          for (auto [dx, dy, dz] : DELTAS) {
-            if (grid[index(x + dx, y + dy, z + dz)]) {
-              ++shared;
-            }
-          }
-        }
+PART1_IMPL(Day18, drop) {
+  auto const steps = face_steps(drop);
+  u32 faces{0};
+  for (u32 i{0}; i < std::size(drop.voxels); ++i) {
+    if (drop.voxels[i] == day18::lava) {
+      // lava never touches the guard shell
+      for (u32 step : steps) {
+        faces += (drop.voxels[i + step] == day18::air);
       }
     }
   }
-  return (6 * voxels) - shared;
+  return faces;
 }
 
-PART2_IMPL(Day18, grid, part1_answer) {
-  using day18::MAX_DIM;
-  constexpr u32 Cubed{MAX_DIM * MAX_DIM * MAX_DIM};
-  owning_span<bool, Cubed> seen(Cubed, false);
-  owning_span<u32, Cubed> frontier;
+PART2_IMPL(Day18, drop, part1_answer) {
+  auto const steps = face_steps(drop);
+  u32 faces{0};
+  // flood the outside air, counting every lava face it runs into
+  auto const neighbors = [&](u32 curr, auto &&emit) noexcept {
+    for (u32 step : steps) {
+      u32 const next{curr + step};
+      if (voxel const v{drop.voxels[next]}; v == day18::air) {
+        emit(next);
+      } else if (v == day18::lava) {
+        ++faces;
+      }
+    }
+  };
+  u32 const source[]{corner(drop)};
+  (void)drop.flood.run(source, neighbors, [](u32) noexcept {
+    return false;
+  });
+  return faces;
+}
+
+PARSE_IMPL(Day18Queue, view) {
+  return Day18{}.parse_input(view);
+}
+
+PART1_IMPL(Day18Queue, drop) {
+  return Day18{}.part1(drop);
+}
+
+PART2_IMPL(Day18Queue, drop, part1_answer) {
+  auto const steps = face_steps(drop);
+  std::vector<bool> seen(std::size(drop.voxels), false);
+  std::vector<u32> frontier(std::size(drop.voxels));
   auto front = std::cbegin(frontier);
   auto back = std::begin(frontier);
-  constexpr i32 const limit{as<i32>(MAX_DIM) - 1};
 
-  *back++ = pack(0, 0, 0);
-  seen[index(0, 0, 0)] = true;
+  *back++ = corner(drop);
+  seen[corner(drop)] = true;
 
   u32 face{0};
 
   while (front != back) {
-    auto const [x, y, z] = unpack(*front++);
-    for (auto [dx, dy, dz] : DELTAS) {
-      bool const xbounds{dx == 0 or (dx < 0 and x > 0) or (dx > 0 and x < limit)};
-      bool const ybounds{dy == 0 or (dy < 0 and y > 0) or (dy > 0 and y < limit)};
-      bool const zbounds{dz == 0 or (dz < 0 and z > 0) or (dz > 0 and z < limit)};
-      if (xbounds and ybounds and zbounds) {
-        if (u32 const idx{index(x + dx, y + dy, z + dz)}; not seen[idx]) {
-          if (not grid[idx]) {
-            // neighbor is an air voxel -- visit
-            *back++ = pack(x + dx, y + dy, z + dz);
-            seen[idx] = true;
-          } else {
-            // neighbor is lava! increment the face count in that direction
-            ++face;
-          }
+    u32 const curr{*front++};
+    for (u32 step : steps) {
+      if (u32 const next{curr + step}; not seen[next]) {
+        if (drop.voxels[next] == day18::air) {
+          // neighbor is an air voxel -- visit
+          *back++ = next;
+          seen[next] = true;
+        } else if (drop.voxels[next] == day18::lava) {
+          // neighbor is lava! increment the face count in that direction
+          ++face;
         }
       }
     }
   }
   return face;
 }
-
 INSTANTIATE_TEST(Day18,
                  R"(
 2,2,2
@@ -120,3 +139,22 @@ INSTANTIATE_TEST(Day18,
 )"sv.substr(1),
                  64,
                  58)
+
+INSTANTIATE_TEST(Day18Queue,
+                 R"(
+2,2,2
+1,2,2
+3,2,2
+2,1,2
+2,3,2
+2,2,1
+2,2,3
+2,2,4
+2,2,6
+1,2,5
+3,2,5
+2,1,5
+2,3,5
+)"sv.substr(1),
+                 64,
+                 58)
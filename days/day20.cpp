@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstring>
 #include <numeric>
+#include <utility>
 
 #include "days/day20.hpp"
 #include "owning_span.hpp"
@@ -80,6 +81,132 @@ run(day20::list_type<i64> const &val, unsigned zero_index) noexcept {
   return val[id[fast_mod(zero + 1000u, N)]] + val[id[fast_mod(zero + 2000u, N)]] + val[id[fast_mod(zero + 3000u, N)]];
 }
 
+//! Implicit treap over the original indices; parent links give an element's position without searching for it
+struct order_tree {
+  constexpr static unsigned const nil{~0u};
+
+  explicit order_tree(unsigned n) noexcept
+      : left(n, nil),
+        right(n, nil),
+        parent(n, nil),
+        count(n, 1u),
+        priority(n) {
+    u32 state{0x9E3779B9u};
+    for (unsigned i{0}; i < n; ++i) {
+      // xorshift32
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      priority[i] = state;
+      root = merge(root, i);
+    }
+    parent[root] = nil;
+  }
+
+  [[nodiscard]] constexpr inline unsigned size(unsigned t) const noexcept {
+    return (t == nil) ? 0u : count[t];
+  }
+
+  constexpr inline void update(unsigned t) noexcept {
+    count[t] = 1u + size(left[t]) + size(right[t]);
+    if (left[t] != nil) {
+      parent[left[t]] = t;
+    }
+    if (right[t] != nil) {
+      parent[right[t]] = t;
+    }
+  }
+
+  [[nodiscard]] unsigned merge(unsigned a, unsigned b) noexcept {
+    if (a == nil) {
+      return b;
+    } else if (b == nil) {
+      return a;
+    } else if (priority[a] > priority[b]) {
+      right[a] = merge(right[a], b);
+      update(a);
+      return a;
+    } else {
+      left[b] = merge(a, left[b]);
+      update(b);
+      return b;
+    }
+  }
+
+  //! the first k elements of t end up in the first tree
+  [[nodiscard]] std::pair<unsigned, unsigned> split(unsigned t, unsigned k) noexcept {
+    if (t == nil) {
+      return {nil, nil};
+    } else if (size(left[t]) >= k) {
+      auto const [a, b] = split(left[t], k);
+      left[t] = b;
+      update(t);
+      return {a, t};
+    } else {
+      auto const [a, b] = split(right[t], k - size(left[t]) - 1u);
+      right[t] = a;
+      update(t);
+      return {t, b};
+    }
+  }
+
+  [[nodiscard]] unsigned rank(unsigned node) const noexcept {
+    unsigned r{size(left[node])};
+    for (unsigned n{node}; parent[n] != nil; n = parent[n]) {
+      if (right[parent[n]] == n) {
+        r += size(left[parent[n]]) + 1u;
+      }
+    }
+    return r;
+  }
+
+  [[nodiscard]] unsigned select(unsigned k) const noexcept {
+    unsigned t{root};
+    while (true) {
+      unsigned const ls{size(left[t])};
+      if (k < ls) {
+        t = left[t];
+      } else if (k == ls) {
+        return t;
+      } else {
+        k -= ls + 1u;
+        t = right[t];
+      }
+    }
+  }
+
+  void move(unsigned node, i64 value) noexcept {
+    i64 const m{as<i64>(size(root)) - 1};
+    unsigned const from{rank(node)};
+    auto const [before, rest] = split(root, from);
+    auto const [self, after] = split(rest, 1u);
+    unsigned const without{merge(before, after)};
+    unsigned const to{as<unsigned>(((as<i64>(from) + value % m) % m + m) % m)};
+    auto const [lhs, rhs] = split(without, to);
+    root = merge(merge(lhs, self), rhs);
+    parent[root] = nil;
+  }
+
+  day20::list_type<unsigned> left, right, parent, count;
+  day20::list_type<u32> priority;
+  unsigned root{nil};
+};
+
+template <unsigned Steps>
+inline i64
+run_tree(day20::list_type<i64> const &val, unsigned zero_index) noexcept {
+  unsigned const N{std::size(val)};
+  order_tree tree(N);
+  for (unsigned step{0}; step < Steps; ++step) {
+    for (unsigned i{0}; i < N; ++i) {
+      tree.move(i, val[i]);
+    }
+  }
+  unsigned const zero{tree.rank(zero_index)};
+  return val[tree.select(fast_mod(zero + 1000u, N))] + val[tree.select(fast_mod(zero + 2000u, N))] +
+         val[tree.select(fast_mod(zero + 3000u, N))];
+}
+
 } // namespace
 
 PARSE_IMPL(Day20, view) {
@@ -115,6 +242,27 @@ SOLVE_IMPL(Day20, Part2, state, part1_answer) {
 
 INSTANTIATE(Day20);
 
+PARSE_IMPL(Day20Tree, view) {
+  return Day20{}.parse_input(view);
+}
+
+SOLVE_IMPL(Day20Tree, Part2, state, part1_answer) {
+  auto const &nums{state.numbers};
+  unsigned const zero_index{state.zero_index};
+
+  if constexpr (not Part2) {
+    return run_tree<1>(nums, zero_index);
+  } else {
+    owning_span<i64, day20::MAXN> numbers(std::size(nums));
+    std::transform(std::begin(nums), std::end(nums), std::begin(numbers), [](i64 val) {
+      return 811'589'153L * val;
+    });
+    return run_tree<10>(numbers, zero_index);
+  }
+}
+
+INSTANTIATE(Day20Tree);
+
 INSTANTIATE_TEST(Day20,
                  R"(
 1
@@ -127,3 +275,16 @@ INSTANTIATE_TEST(Day20,
 )"sv.substr(1),
                  3L,
                  1623178306L)
+
+INSTANTIATE_TEST(Day20Tree,
+                 R"(
+1
+2
+-3
+3
+-2
+0
+4
+)"sv.substr(1),
+                 3L,
+                 1623178306L)
@@ -0,0 +1,129 @@
+#include <cstdio>
+
+#include "days/day24.hpp"
+#include "parsing.hpp"
+
+namespace {
+
+using day24::row_t;
+
+//! Earliest minute at which the expedition, waiting at its entrance from minute t, steps out of the far exit.
+/*! The reachable set is advanced one whole row at a time: stay, shift left/right and step from the rows above and
+ *  below, then clear cells covered by blizzards at the new minute. Horizontal blizzards are rotated rows and vertical
+ *  blizzards are rotated row indices, so no state beyond the frontier is updated per minute.
+ */
+[[nodiscard]] u32
+crossing(day24::basin const &b, u32 t, bool downward) noexcept {
+  u32 const w{b.width};
+  u32 const h{b.height};
+  if (w == 0 or h == 0) {
+    // an input that did not fit (see parse) is left empty
+    return t;
+  }
+  row_t const mask{(row_t{1} << w) - 1};
+  row_t const first_col{1};
+  row_t const last_col{row_t{1} << (w - 1)};
+
+  u32 const entry_row{downward ? 0 : h - 1};
+  row_t const entry_bit{downward ? first_col : last_col};
+  u32 const exit_row{downward ? h - 1 : 0};
+  row_t const exit_bit{downward ? last_col : first_col};
+
+  // padded with an empty row above and below
+  std::array<row_t, day24::MAX_HEIGHT + 2> frontier{};
+  u32 tw{t % w};
+  u32 th{t % h};
+  while (not(frontier[exit_row + 1] & exit_bit)) {
+    ++t;
+    tw = (tw + 1 == w) ? 0 : tw + 1;
+    th = (th + 1 == h) ? 0 : th + 1;
+    row_t above{0};
+    for (u32 y{0}; y < h; ++y) {
+      row_t const here{frontier[y + 1]};
+      row_t moves{here | (here << 1) | (here >> 1) | above | frontier[y + 2]};
+      if (y == entry_row) {
+        moves |= entry_bit;
+      }
+      u32 const up_row{(y + th >= h) ? y + th - h : y + th};
+      u32 const down_row{(y + h - th >= h) ? y - th : y + h - th};
+      row_t const blizzards{(((b.right[y] << tw) | (b.right[y] >> (w - tw))) & mask) |
+                            (((b.left[y] >> tw) | (b.left[y] << (w - tw))) & mask) | b.up[up_row] |
+                            b.down[down_row]};
+      above = here;
+      frontier[y + 1] = moves & mask & ~blizzards;
+    }
+  }
+  // one more minute to step onto the exit
+  return t + 1;
+}
+
+} // namespace
+
+PARSE_IMPL(Day24, view) {
+  day24::basin result;
+  usize const first_newline{view.find('\n')};
+  // the last line may lack its newline
+  usize const lines{first_newline == std::string_view::npos ? 0 : (std::size(view) + 1) / (first_newline + 1)};
+  if (first_newline < 3 or lines < 3) {
+    // walls on all four sides around at least one open cell
+    (void)fprintf(stderr, "Day 24 input is not a basin\n");
+    return {};
+  }
+  u32 const stride{as<u32>(first_newline) + 1};
+  result.width = stride - 3;
+  result.height = as<u32>(lines) - 2;
+  if (result.width > day24::MAX_WIDTH or result.height > day24::MAX_HEIGHT) {
+    (void)fprintf(stderr,
+                  "Day 24 basin is %ux%u but at most %ux%u fits\n",
+                  result.width,
+                  result.height,
+                  day24::MAX_WIDTH,
+                  day24::MAX_HEIGHT);
+    return {};
+  }
+  for (u32 y{0}; y < result.height; ++y) {
+    std::string_view const line{unsafe_substr(view, (y + 1) * stride + 1, result.width)};
+    for (u32 x{0}; x < result.width; ++x) {
+      row_t const bit{row_t{1} << x};
+      switch (line[x]) {
+      case '>':
+        result.right[y] |= bit;
+        break;
+      case '<':
+        result.left[y] |= bit;
+        break;
+      case '^':
+        result.up[y] |= bit;
+        break;
+      case 'v':
+        result.down[y] |= bit;
+        break;
+      default:
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+PART1_IMPL(Day24, basin) {
+  return crossing(basin, 0, true);
+}
+
+PART2_IMPL(Day24, basin, part1_answer) {
+  u32 const there{part1_answer.has_value() ? part1_answer.value() : crossing(basin, 0, true)};
+  u32 const back{crossing(basin, there, false)};
+  return crossing(basin, back, true);
+}
+
+INSTANTIATE_TEST(Day24,
+                 R"(
+#.######
+#>>.<^<#
+#.<..<<#
+#>v.><>#
+#<^v^^>#
+######.#
+)"sv.substr(1),
+                 18u,
+                 54u)
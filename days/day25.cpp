@@ -0,0 +1,178 @@
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#include "days/day25.hpp"
+
+namespace {
+
+using day25::sum_t;
+
+//! SNAFU digit values; anything else (only '\n' in practice) decodes to zero
+constexpr std::array<i8, 256> const digit_value{[] {
+  std::array<i8, 256> result{};
+  result['2'] = 2;
+  result['1'] = 1;
+  result['0'] = 0;
+  result['-'] = -1;
+  result['='] = -2;
+  return result;
+}()};
+
+// log5(2^127) < 56
+constexpr u32 const MAX_DIGITS{56};
+// one vector lane per column; a SNAFU number that fits in i64 has at most 28 digits
+constexpr u32 const MAX_COLUMNS{32};
+
+[[nodiscard]] inline std::string_view
+next_line(std::string_view &view) noexcept {
+  auto const *const nl = static_cast<char const *>(std::memchr(std::data(view), '\n', std::size(view)));
+  usize const length{nl == nullptr ? std::size(view) : as<usize>(nl - std::data(view))};
+  std::string_view const line{std::data(view), length};
+  view.remove_prefix(std::min(length + 1, std::size(view)));
+  return line;
+}
+
+//! Balanced base-5 encoding: shifting the value by two maps every residue straight onto "=-012"
+/*! The residue is taken non-negative and the quotient rounded down, so negative totals encode with a leading '-' or
+ *  '=' rather than indexing outside the digit table.
+ */
+[[nodiscard]] std::string
+encode(sum_t value) noexcept {
+  std::array<char, MAX_DIGITS> buffer;
+  u32 pos{MAX_DIGITS};
+  do {
+    sum_t const shifted{value + 2};
+    sum_t const residue{(shifted % 5 + 5) % 5};
+    buffer[--pos] = "=-012"[as<u32>(residue)];
+    value = (shifted - residue) / 5;
+  } while (value != 0);
+  return std::string{std::data(buffer) + pos, MAX_DIGITS - pos};
+}
+
+} // namespace
+
+PARSE_IMPL(Day25, view) {
+  sum_t total{0};
+  while (not view.empty()) {
+    i64 value{0};
+    for (char const c : next_line(view)) {
+      value = value * 5 + digit_value[as<u8>(c)];
+    }
+    total += value;
+  }
+  return total;
+}
+
+PARSE_IMPL(Day25Columns, view) {
+  typedef i8 digits_t __attribute__((vector_size(MAX_COLUMNS)));
+  typedef i16 partial_t __attribute__((vector_size(2 * MAX_COLUMNS)));
+  // |digit| <= 2, so this many lines fit the 16-bit partial sums
+  constexpr u32 const flush_every{16'000};
+
+  // each line is loaded as the MAX_COLUMNS bytes ending at its last digit, so lane MAX_COLUMNS - 1 is the units
+  digits_t lane;
+  for (u32 l{0}; l < MAX_COLUMNS; ++l) {
+    lane[l] = as<i8>(l);
+  }
+  char const *const first{std::data(view)};
+  partial_t partial{};
+  std::array<i64, MAX_COLUMNS> sums{};
+  auto const flush = [&] {
+    for (u32 l{0}; l < MAX_COLUMNS; ++l) {
+      sums[MAX_COLUMNS - 1 - l] += partial[l];
+    }
+    partial = partial_t{};
+  };
+  for (u32 pending{0}; not view.empty();) {
+    std::string_view const line{next_line(view)};
+    if (line.empty()) {
+      continue;
+    }
+    if (std::size(line) > MAX_COLUMNS) {
+      (void)fprintf(stderr, "Day 25 numbers have at most %u digits\n", MAX_COLUMNS);
+      return 0;
+    }
+    char const *const end{std::data(line) + std::size(line)};
+    digits_t chars;
+    if (end - first >= MAX_COLUMNS) {
+      std::memcpy(&chars, end - MAX_COLUMNS, MAX_COLUMNS);
+    } else {
+      // too close to the start of the input to load the bytes before the line
+      std::array<char, MAX_COLUMNS> padded{};
+      std::memcpy(std::data(padded) + MAX_COLUMNS - std::size(line), std::data(line), std::size(line));
+      std::memcpy(&chars, std::data(padded), MAX_COLUMNS);
+    }
+    digits_t value{chars - '0'};
+    value = (chars == '-') ? digits_t{} - 1 : value;
+    value = (chars == '=') ? digits_t{} - 2 : value;
+    // lanes ahead of the line hold the end of earlier lines
+    value &= (lane >= as<i8>(MAX_COLUMNS - std::size(line)));
+    partial += __builtin_convertvector(value, partial_t);
+    if (++pending == flush_every) {
+      flush();
+      pending = 0;
+    }
+  }
+  flush();
+  sum_t total{0};
+  for (u32 i{MAX_COLUMNS}; i-- > 0;) {
+    total = total * 5 + sums[i];
+  }
+  return total;
+}
+
+PART1_IMPL(Day25, total) {
+  return encode(total);
+}
+
+PART2_IMPL(Day25, total, part1_answer) {
+  (void)total;
+  return "*"sv;
+}
+
+PART1_IMPL(Day25Columns, total) {
+  return encode(total);
+}
+
+PART2_IMPL(Day25Columns, total, part1_answer) {
+  (void)total;
+  return "*"sv;
+}
+
+#ifndef DOCTEST_CONFIG_DISABLE
+namespace {
+
+constexpr std::string_view const example{R"(
+1=-0-2
+12111
+2=0=
+21
+2=01
+111
+20012
+112
+1=-1=
+1-12
+12
+1=
+122
+)"sv.substr(1)};
+
+} // namespace
+#endif
+
+INSTANTIATE_TEST(Day25, example, "2=-1=0", "*"sv)
+
+INSTANTIATE_TEST(Day25Columns, example, "2=-1=0", "*"sv)
+
+#ifndef DOCTEST_CONFIG_DISABLE
+TEST_CASE("Day25 negative totals and blank lines") {
+  // -3 - 1 = -4 = -5 + 1
+  std::string_view const input{"-2\n\n-\n"};
+  CHECK_EQ(Day25{}.part1(Day25{}.parse_input(input)), "-1");
+  CHECK_EQ(Day25Columns{}.part1(Day25Columns{}.parse_input(input)), "-1");
+  // one digit more than the column sums hold
+  CHECK_EQ(Day25Columns{}.part1(Day25Columns{}.parse_input("100000000000000000000000000000000\n"sv)), "0");
+}
+#endif
@@ -26,6 +26,8 @@
 #include "days/day21.hpp"
 #include "days/day22.hpp"
 #include "days/day23.hpp"
+#include "days/day24.hpp"
+#include "days/day25.hpp"
 
 using all_days = std::tuple<Day01,
                             Day02,
@@ -49,6 +51,8 @@ using all_days = std::tuple<Day01,
                             Day20,
                             Day21,
                             Day22,
-                            Day23>;
+                            Day23,
+                            Day24,
+                            Day25>;
 
 constexpr inline static usize const implemented_days = std::tuple_size_v<all_days>;
@@ -3,6 +3,7 @@
 #include <cstdio>
 #include <optional>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 
 #ifndef DOCTEST_CONFIG_DISABLE
@@ -13,9 +14,19 @@
 
 using std::string_view_literals::operator""sv;
 
-template <u32 Number, typename ParseResult, typename Part1Result, typename Part2Result = Part1Result>
+//! Tag for a day's only (or primary) implementation
+struct primary_variant {
+  constexpr static std::string_view const name{"primary"};
+};
+
+template <u32 Number,
+          typename ParseResult,
+          typename Part1Result,
+          typename Part2Result = Part1Result,
+          typename Variant = primary_variant>
 struct Day {
   constexpr static u32 const number{Number};
+  constexpr static std::string_view const variant{Variant::name};
 
   using parse_result_t = ParseResult;
   using part1_result_t = Part1Result;
@@ -39,6 +50,17 @@ private:
         [[maybe_unused]] std::optional<part1_result_t> const &part1_answer) const noexcept;
 };
 
+//! Registry of named implementations of a day; the first entry is the one listed in all_days
+/*! Specialize next to the day's alias to benchmark alternatives side by side (--variant/--all-variants)
+ */
+template <typename DayT>
+struct day_variants {
+  using type = std::tuple<DayT>;
+};
+
+template <typename DayT>
+using day_variants_t = typename day_variants<DayT>::type;
+
 //! Macro for generating function signature for parse
 #define PARSE_IMPL(DAY, ParamBuffer)                                                                                   \
   /* Class template specialization */                                                                                  \
@@ -1,5 +1,4 @@
-#include <array>
-
 #include "days/day.hpp"
+#include "top_k.hpp"
 
-using Day01 = Day<1, std::array<u32, 3>, u32>;
+using Day01 = Day<1, top_k<u32, 3>, u32>;
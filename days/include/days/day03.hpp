@@ -1,9 +1,13 @@
 #include "days/day.hpp"
-#include "owning_span.hpp"
-#include <string_view>
 
 namespace day03 {
-using list_t = owning_span<std::string_view, 300>;
-}
 
-using Day03 = Day<3, day03::list_t, int>;
+//! both answers are accumulated while scanning the input once
+struct totals {
+  int misplaced{0};
+  int badges{0};
+};
+
+} // namespace day03
+
+using Day03 = Day<3, day03::totals, int>;
@@ -1,30 +1,21 @@
+#include <array>
+
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day04 {
 
-constexpr u32 const MAX_RANGES{1000};
-
-struct interval {
-  u32 lo, hi;
+//! assignments are counted in fixed-size structure-of-arrays batches, so input length is unbounded
+constexpr u32 const BATCH_SIZE{256};
 
-  [[gnu::always_inline]] [[nodiscard]] inline bool encloses(interval const &other) const noexcept {
-    return lo >= other.lo and hi <= other.hi;
-  }
+struct batch {
+  std::array<u32, BATCH_SIZE> a_lo, a_hi, b_lo, b_hi;
 };
 
-struct range {
-  interval a, b;
-
-  [[gnu::always_inline]] [[nodiscard]] inline bool encloses() const noexcept {
-    return a.encloses(b) or b.encloses(a);
-  }
-
-  [[gnu::always_inline]] [[nodiscard]] inline bool overlaps() const noexcept {
-    return (b.lo <= a.hi and a.lo <= b.hi);
-  }
+struct counts {
+  u32 contained{0};
+  u32 overlapping{0};
 };
 
 } // namespace day04
 
-using Day04 = Day<4, owning_span<day04::range, day04::MAX_RANGES>, u32>;
+using Day04 = Day<4, day04::counts, u32>;
@@ -1,29 +1,76 @@
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day05 {
 
-constexpr u32 const MAX_STACK_HEIGHT{60};
-constexpr u32 const MAX_STACKS{9};
-constexpr u32 const MAX_COMMANDS{512};
+//! flat strings: copies the moved crates, cheapest while stacks stay small (the puzzle input)
+struct copy {
+  constexpr static std::string_view const name{"copy"};
+};
 
-using stack_t = owning_span<char, MAX_STACK_HEIGHT>;
-using stacks_t = owning_span<stack_t, MAX_STACKS>;
+//! treap rope: O(log n) per move however many crates move
+struct rope {
+  constexpr static std::string_view const name{"rope"};
+};
 
 struct command {
   u32 count, from, to;
-
-  template <bool Bulk>
-  [[gnu::always_inline]] inline void execute(stacks_t &stacks) const noexcept;
 };
 
-using commands_t = owning_span<command, MAX_COMMANDS>;
+using commands_t = std::vector<command>;
 
 struct state {
-  stacks_t stacks;
+  // crates of every stack, bottom to top
+  std::vector<std::string> stacks;
+  commands_t commands;
+};
+
+constexpr u32 const nil{~0u};
+
+//! One crate in an implicit treap (a rope ordered bottom to top); flip is a pending reversal of the subtree
+struct node {
+  u32 left{nil};
+  u32 right{nil};
+  u32 size{1};
+  u32 priority;
+  char crate;
+  bool flip{false};
+};
+
+//! Every stack is a treap over a shared node pool, so moving k crates is a split and a merge: O(log n)
+struct ropes_t {
+  std::vector<node> nodes;
+  std::vector<u32> roots;
+
+  [[nodiscard]] inline u32 size(u32 t) const noexcept {
+    return (t == nil) ? 0u : nodes[t].size;
+  }
+
+  void push_down(u32 t) noexcept;
+  void update(u32 t) noexcept;
+  [[nodiscard]] u32 merge(u32 a, u32 b) noexcept;
+  //! the first (bottom) k crates of t end up in the first tree
+  [[nodiscard]] std::pair<u32, u32> split(u32 t, u32 k) noexcept;
+  [[nodiscard]] char top(u32 t) noexcept;
+
+  template <bool Bulk>
+  [[gnu::always_inline]] inline void execute(command const &c) noexcept;
+};
+
+struct rope_state {
+  ropes_t stacks;
   commands_t commands;
 };
 
 } // namespace day05
 
-using Day05 = Day<5, day05::state, std::string>;
+using Day05 = Day<5, day05::state, std::string, std::string, day05::copy>;
+using Day05Rope = Day<5, day05::rope_state, std::string, std::string, day05::rope>;
+
+template <>
+struct day_variants<Day05> {
+  using type = std::tuple<Day05, Day05Rope>;
+};
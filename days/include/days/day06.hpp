@@ -1,9 +1,23 @@
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day06 {
-constexpr u32 const MAX_LEN{4096};
-using buffer_t = owning_span<i8, MAX_LEN>;
+
+//! counted sliding window whose start skips past each repeat
+struct skip {
+  constexpr static std::string_view const name{"skip"};
+};
+
+//! eight candidate windows per step as 32-bit letter sets
+struct lanes {
+  constexpr static std::string_view const name{"lanes"};
+};
+
 } // namespace day06
 
-using Day06 = Day<6, day06::buffer_t, i64>;
+using Day06 = Day<6, std::string_view, i64, i64, day06::skip>;
+using Day06Lanes = Day<6, std::string_view, i64, i64, day06::lanes>;
+
+template <>
+struct day_variants<Day06> {
+  using type = std::tuple<Day06, Day06Lanes>;
+};
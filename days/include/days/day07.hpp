@@ -1,9 +1,70 @@
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day07 {
-constexpr u32 const MAX_DIRS{512};
-constexpr u32 const MAX_DEPTH{10};
+
+struct directory {
+  // the name is m_names[name_offset, name_offset + name_length) of the filesystem, shared by every equal name
+  u32 name_offset;
+  u32 name_length;
+  u32 parent;
+  u64 file_bytes{0};
+  u64 total_bytes{0};
+  bool listed{false};
+};
+
+//! Directory tree rebuilt from a terminal log, with indexes for path and size queries
+class filesystem {
+public:
+  explicit filesystem(std::string_view log);
+
+  //! total size of "/", including everything below it
+  [[nodiscard]] u64 used() const noexcept;
+
+  //! total size of an absolute path such as "/a/e", if that directory was seen
+  [[nodiscard]] std::optional<u64> size_of(std::string_view path) const noexcept;
+
+  //! smallest directory total that is at least bytes
+  [[nodiscard]] std::optional<u64> smallest_at_least(u64 bytes) const noexcept;
+
+  //! sum of every directory total that is at most bytes (nested directories count again)
+  [[nodiscard]] u64 sum_at_most(u64 bytes) const noexcept;
+
+  //! name of a directory ("/" for the root)
+  [[nodiscard]] std::string_view name(u32 dir) const noexcept;
+
+  //! subdirectories of a directory, ordered by name
+  [[nodiscard]] std::span<u32 const> children(u32 dir) const noexcept;
+
+  [[nodiscard]] usize size() const noexcept;
+
+private:
+  //! the slot of m_slots holding the entry for (parent, name), or the empty slot where it belongs; hash is the name's
+  [[nodiscard]] usize find_slot(u32 parent, std::string_view name, usize hash) const noexcept;
+  //! the child of parent called name, created when first seen
+  u32 add_child(u32 parent, std::string_view name);
+  //! sets up m_children and m_child_begin once every directory is known
+  void index_children();
+
+  std::vector<directory> m_dirs;
+  // every distinct directory name, each stored once
+  std::string m_names;
+  // open-addressing table used while replaying the log, kept at most half full; empty slots hold ~0.
+  // (parent, name) maps to the child directory, and (~0, name) to the first directory with that name, tagged.
+  std::vector<u32> m_slots;
+  usize m_entries{0};
+  // the children of dir are m_children[m_child_begin[dir], m_child_begin[dir + 1])
+  std::vector<u32> m_children;
+  std::vector<u32> m_child_begin;
+  // every directory total, ascending, and the running sums of that order
+  std::vector<u64> m_totals;
+  std::vector<u64> m_prefix;
+};
+
 } // namespace day07
 
-using Day07 = Day<7, owning_span<u32, day07::MAX_DIRS>, u32>;
+using Day07 = Day<7, day07::filesystem, u64>;
@@ -1,20 +1,17 @@
-#include <string_view>
+#include <string>
 
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day08 {
 
-constexpr u32 const GRID_SIZE{99};
-
-using visible_t = owning_span<u32, as<u32>(GRID_SIZE * GRID_SIZE)>;
-using grid_t = owning_span<std::string_view, GRID_SIZE>;
-
-struct result {
-  visible_t visible;
-  grid_t grid;
-  u32 size;
+//! tree heights as digits, row-major, plus the same grid transposed so column sweeps read contiguous memory
+struct forest {
+  std::string rows;
+  std::string columns;
+  u32 width;
+  u32 height;
 };
+
 } // namespace day08
 
-using Day08 = Day<8, day08::result, i64>;
+using Day08 = Day<8, day08::forest, i64>;
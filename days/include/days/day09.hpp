@@ -1,11 +1,16 @@
+#include <vector>
+
 #include "days/day.hpp"
-#include "offset_grid.hpp"
-#include "owning_span.hpp"
+#include "point2d.hpp"
 
 namespace day09 {
-constexpr u32 const MAX_GRID_POINTS{98304};
+//! a knot moving `count` times by the same unit `step` (which may be diagonal for knots behind the head)
+struct run {
+  point2d step;
+  i32 count;
+};
 
-using grid_type = offset_grid<u16, owning_span<u16, day09::MAX_GRID_POINTS>>;
+using motion = std::vector<run>;
 } // namespace day09
 
-using Day09 = Day<9, day09::grid_type, i64>;
+using Day09 = Day<9, day09::motion, i64>;
@@ -1,10 +1,30 @@
-#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "days/day.hpp"
-#include "owning_span.hpp"
 
 namespace day10 {
-using xstate_t = owning_span<i32, 240>;
-}
 
-using Day10 = Day<10, day10::xstate_t, i32, std::string_view>;
+//! The handheld's register machine, decoded once into the cycles at which X changes
+class cpu {
+public:
+  explicit cpu(std::string_view program) noexcept;
+
+  //! X during each of the ascending 1-based cycles, written to x
+  void sample(std::span<u32 const> cycles, std::span<i32> x) const noexcept;
+
+  //! number of cycles the program takes to run
+  [[nodiscard]] u64 cycles() const noexcept;
+
+private:
+  // the cycle each X-writing instruction retires on, and X before the first of them and after each
+  std::vector<u64> m_retire;
+  std::vector<i32> m_x;
+  u64 m_cycles{0};
+};
+
+} // namespace day10
+
+using Day10 = Day<10, day10::cpu, i32, std::string>;
@@ -1,4 +1,9 @@
+#include <array>
+#include <span>
+#include <string_view>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "days/day.hpp"
 #include "owning_span.hpp"
@@ -18,35 +23,6 @@ fast_evenly_divisible(T value) noexcept {
   return (value % Mod) == 0;
 }
 
-template <typename T>
-constinit T static inline bigmod = T{2} * T{3} * T{5} * T{7} * T{11} * T{13} * T{17} * T{19} * T{23};
-
-template <op_type Op>
-[[nodiscard, gnu::always_inline]] inline constexpr auto
-new_value(u32 old, u32 rhs) noexcept {
-  if constexpr (Op == op_type::squares) {
-    return as<u64>(old) * as<u64>(old);
-  } else if constexpr (Op == op_type::plus) {
-    return old + rhs;
-  } else {
-    return old * rhs;
-  }
-}
-
-template <bool Part2, typename U>
-[[nodiscard, gnu::always_inline]] inline constexpr u32
-update(U res) noexcept {
-  if constexpr (Part2) {
-    if (res > bigmod<U>) [[unlikely]] {
-      return as<u32>(res % bigmod<U>);
-    } else {
-      return as<u32>(res);
-    }
-  } else {
-    return as<u32>(res / U{3});
-  }
-}
-
 } // namespace detail
 
 class operation {
@@ -73,14 +49,22 @@ public:
     return {rhs, op_type::multiplies};
   }
 
-  template <bool Part2>
-  [[nodiscard, gnu::always_inline]] constexpr inline u32 new_worry_level(u32 old) const noexcept {
+  [[nodiscard]] constexpr inline op_type type() const noexcept {
+    return m_op;
+  }
+
+  [[nodiscard]] constexpr inline u32 rhs() const noexcept {
+    return m_rhs;
+  }
+
+  //! worry level after the inspection, before any relief or reduction
+  [[nodiscard, gnu::always_inline]] constexpr inline u64 apply(u64 old) const noexcept {
     if (m_op == op_type::plus) [[likely]] {
-      return detail::update<Part2>(detail::new_value<op_type::plus>(old, m_rhs));
+      return old + m_rhs;
     } else if (m_op == op_type::multiplies) {
-      return detail::update<Part2>(detail::new_value<op_type::multiplies>(old, m_rhs));
+      return old * m_rhs;
     } else {
-      return detail::update<Part2>(detail::new_value<op_type::squares>(old, m_rhs));
+      return old * old;
     }
   }
 };
@@ -88,7 +72,6 @@ public:
 using items_type = owning_span<u32, MAX_ITEMS>;
 
 class monkey {
-  u64 m_inspection_count{0};
   items_type m_items;
   operation m_op{};
   u8 div_amount;
@@ -111,24 +94,19 @@ public:
     return m_items;
   }
 
-  constexpr inline void update_throws() noexcept {
-    m_inspection_count += std::size(m_items);
-    m_items.resize(0);
-  }
-
-  constexpr inline void catch_item(u32 item) noexcept {
-    m_items.push(item);
+  constexpr inline operation const &get_op() const noexcept {
+    return m_op;
   }
 
-  constexpr inline u64 count() noexcept {
-    return m_inspection_count;
+  [[nodiscard]] constexpr inline u32 divisor() const noexcept {
+    return div_amount;
   }
 
-  constexpr inline operation const &get_op() noexcept {
-    return m_op;
+  [[nodiscard]] constexpr inline u32 target(bool divisible) const noexcept {
+    return divisible ? if_true : if_false;
   }
 
-  [[nodiscard]] constexpr inline u32 get_destination(u32 value) const noexcept {
+  [[nodiscard]] constexpr inline u32 get_destination(u64 value) const noexcept {
     bool const cond = [](auto v, auto d) noexcept {
       switch (d) {
       case 3:
@@ -155,6 +133,52 @@ public:
   }
 };
 
+//! Product of the two largest inspection counts after `rounds` rounds. With Relief worry levels are divided by three
+//! after each inspection and must stay within 64 bits, otherwise they are kept modulo the product of the divisors.
+template <bool Relief>
+[[nodiscard]] u64 monkey_business(std::span<monkey const> monkeys, u64 rounds) noexcept;
+
+//! Monkeys as structure-of-arrays item buffers, played a whole round at a time
+class troop {
+public:
+  explicit troop(std::span<monkey const> monkeys) noexcept;
+
+  //! Same as day11::monkey_business, but every monkey inspects its whole batch of items at once; falls back to it
+  //! when a worry level reaches 2^48, past which the batched arithmetic is no longer exact
+  template <bool Relief>
+  [[nodiscard]] u64 monkey_business(u64 rounds) const noexcept;
+
+private:
+  owning_span<monkey, MAX_MONKEYS> m_monkeys;
+  u32 m_size;
+  // room for every item plus a vector's worth of padding
+  u32 m_capacity;
+  u32 m_modulus{1};
+  // items held by monkey m are m_worry[m * m_capacity, m * m_capacity + m_held[m])
+  std::vector<u64> m_worry;
+  std::array<u32, MAX_MONKEYS> m_held{};
+  std::array<operation, MAX_MONKEYS> m_ops{};
+  std::array<u32, MAX_MONKEYS> m_divisor{};
+  std::array<u32, MAX_MONKEYS> m_if_true{};
+  std::array<u32, MAX_MONKEYS> m_if_false{};
+};
+
+//! follow each item separately and extrapolate its cycle
+struct by_item {
+  constexpr static std::string_view const name{"items"};
+};
+
+//! play every round for all items
+struct by_round {
+  constexpr static std::string_view const name{"rounds"};
+};
+
 } // namespace day11
 
-using Day11 = Day<11, owning_span<day11::monkey, day11::MAX_MONKEYS>, u64>;
+using Day11 = Day<11, owning_span<day11::monkey, day11::MAX_MONKEYS>, u64, u64, day11::by_item>;
+using Day11Rounds = Day<11, day11::troop, u64, u64, day11::by_round>;
+
+template <>
+struct day_variants<Day11> {
+  using type = std::tuple<Day11, Day11Rounds>;
+};
@@ -1,18 +1,45 @@
+#include <string>
+
+#include "bitset_bfs.hpp"
 #include "days/day.hpp"
-#include "owning_span.hpp"
+#include "grid_search.hpp"
 
 namespace day12 {
 
-constexpr u32 const MAX_SIZE{8192};
-
-struct map {
-  owning_span<char, MAX_SIZE> grid;
+//! elevations row by row ('a' to 'z', with S and E as 'a' and 'z'), each row ended by '\n'
+struct height_map {
+  std::string cells;
+  u32 stride;
   u32 start;
-  u32 stop;
-  u32 width;
-  u32 height;
+  u32 summit;
+  // sized for cells when parsed and reused by every solve
+  mutable grid_search::engine<> search{};
+};
+
+struct terrain {
+  // uphill moves: at most one higher, any amount lower
+  bitset_bfs climb;
+  bitset_bfs::cell_set start;
+  bitset_bfs::cell_set lowest;
+  bitset_bfs::cell_set summit;
+};
+
+//! one square at a time through grid_search::engine
+struct search {
+  constexpr static std::string_view const name{"search"};
+};
+
+//! whole frontiers at once as shifted bitsets
+struct bitsets {
+  constexpr static std::string_view const name{"bitsets"};
 };
 
 } // namespace day12
 
-using Day12 = Day<12, day12::map, u32>;
+using Day12 = Day<12, day12::height_map, u32, u32, day12::search>;
+using Day12Bitsets = Day<12, day12::terrain, u32, u32, day12::bitsets>;
+
+template <>
+struct day_variants<Day12> {
+  using type = std::tuple<Day12, Day12Bitsets>;
+};
@@ -1,70 +1,40 @@
-#include <array>
-#include <compare>
-#include <limits>
-#include <span>
-#include <utility>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "days/day.hpp"
 
 namespace day13 {
 
-struct structure;
+//! Every packet as a flat byte key; comparing two keys bytewise orders their packets the way the puzzle does
+/*! A key is one big-endian u16 per token: numbers, list closings, and list openings tagged with the list's first number
+ *  so that a number meeting a list is settled on the spot. A list holding just one number is keyed as that number,
+ *  which is how the puzzle compares it. Input with a number above max_number is rejected and leaves no packets.
+ */
+class packets {
+public:
+  //! the largest packet number a token can hold
+  constexpr static u32 const max_number{32766};
 
-struct handle {
+  explicit packets(std::string_view input) noexcept;
 
-  using type = i16;
+  //! key of a single packet
+  [[nodiscard]] static std::string key(std::string_view packet) noexcept;
 
-  static constexpr inline void set_data(handle const *data_pointer) {
-    handle::data = data_pointer;
+  [[nodiscard]] inline usize size() const noexcept {
+    return std::size(m_ends);
   }
 
-  constexpr inline handle(type v) noexcept
-      : value{v} {
+  [[nodiscard]] inline std::string_view operator[](usize i) const noexcept {
+    usize const begin{i == 0 ? 0 : m_ends[i - 1]};
+    return std::string_view{m_keys}.substr(begin, m_ends[i] - begin);
   }
 
-  constexpr inline handle() noexcept = default;
-  constexpr inline handle(handle &&) noexcept = default;
-  constexpr inline handle(handle const &) noexcept = default;
-  constexpr inline handle &operator=(handle &&) noexcept = default;
-  constexpr inline handle &operator=(handle const &) noexcept = default;
-
-  constexpr inline std::partial_ordering operator<=>(handle const &) const noexcept;
-  constexpr inline bool operator==(handle const &) const noexcept = default;
-  constexpr inline bool operator!=(handle const &) const noexcept = default;
-
-  [[nodiscard]] constexpr inline type get_value() const noexcept;
-  [[nodiscard]] constexpr inline std::span<handle const> get_list() const noexcept;
-
-  type value{std::numeric_limits<type>::min()};
-
 private:
-  static inline handle const *data = nullptr;
-};
-
-static constexpr handle Null = handle{};
-static constexpr u32 MAX_CELLS{16384};
-static constexpr u32 MAX_LEN{6};
-static constexpr u32 MAX_ELEMS{300};
-
-struct structure {
-
-  constexpr inline structure(std::string_view buffer) noexcept;
-  [[nodiscard]] constexpr inline std::span<handle const> trials() const noexcept;
-  [[nodiscard]] constexpr inline handle const *data() const noexcept;
-
-private:
-  // parse functions
-  constexpr inline handle List() noexcept;
-  constexpr inline handle Elem() noexcept;
-
-  char const *ptr{nullptr};
-  char const *end{nullptr};
-  std::array<handle, MAX_CELLS> heap;
-  std::array<handle, MAX_ELEMS> raw_elems;
-  u32 num_elems{0};
-  typename handle::type brk{1};
+  std::string m_keys;
+  std::vector<u32> m_ends;
 };
 
 } // namespace day13
 
-using Day13 = Day<13, day13::structure, i64>;
+using Day13 = Day<13, day13::packets, i64>;
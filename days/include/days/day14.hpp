@@ -1,14 +1,58 @@
-#include <cstddef>
+#include <span>
+#include <vector>
 
 #include "days/day.hpp"
-#include "offset_grid.hpp"
-#include "owning_span.hpp"
+#include "point2d.hpp"
 
 namespace day14 {
-constexpr inline u32 const MAX_POINTS{880};
-constexpr inline u32 const MAX_WIDTH{60};
-constexpr inline u32 const MAX_HEIGHT{185};
-using cave_type = offset_grid<char, owning_span<char, as<u32>(MAX_WIDTH * MAX_HEIGHT)>>;
+
+constexpr inline i32 const source_x{500};
+
+//! Rock as one bitset per row, over every square sand from (500, 0) can reach above the floor
+/*! Sand moves at most one column per row, so row y only needs the columns within y of the source; the rows span the
+ *  widest of them, 500 +/- (floor - 1). Bit 0 of a row's first word is its leftmost column.
+ */
+class cave {
+public:
+  //! `floor` is the depth of the floor two below the lowest rock
+  explicit cave(i32 floor) noexcept;
+
+  //! rock along a horizontal or vertical line, clipped to the reachable columns
+  void add_rock(point2d from, point2d to) noexcept;
+
+  [[nodiscard]] inline i32 floor() const noexcept {
+    return m_floor;
+  }
+
+  [[nodiscard]] inline u32 row_words() const noexcept {
+    return m_row_words;
+  }
+
+  [[nodiscard]] inline std::span<u64 const> row(i32 y) const noexcept {
+    return {std::data(m_bits) + as<u32>(y) * m_row_words, m_row_words};
+  }
+
+  [[nodiscard]] inline bool test(i32 x, i32 y) const noexcept {
+    u32 const bit{column(x)};
+    return (m_bits[as<u32>(y) * m_row_words + bit / 64] >> (bit % 64)) & 1;
+  }
+
+  inline void set(i32 x, i32 y) noexcept {
+    u32 const bit{column(x)};
+    m_bits[as<u32>(y) * m_row_words + bit / 64] |= 1LU << (bit % 64);
+  }
+
+private:
+  [[nodiscard]] inline u32 column(i32 x) const noexcept {
+    return as<u32>(x - m_left);
+  }
+
+  i32 m_floor;
+  i32 m_left;
+  u32 m_row_words;
+  std::vector<u64> m_bits;
+};
+
 } // namespace day14
 
-using Day14 = Day<14, day14::cave_type, u32>;
+using Day14 = Day<14, day14::cave, u32>;
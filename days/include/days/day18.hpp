@@ -1,9 +1,43 @@
+#include <vector>
+
 #include "days/day.hpp"
-#include "owning_span.hpp"
+#include "grid_search.hpp"
 
 namespace day18 {
-constexpr u32 const MAX_DIM{24};
-using grid_type = owning_span<u8, as<u32>(MAX_DIM * MAX_DIM * MAX_DIM)>;
+
+enum voxel : u8 { air, lava, guard };
+
+//! the droplet's bounding box inside a shell of air, inside a shell of guard voxels
+struct droplet {
+  // extents along x, y and z
+  u32 width;
+  u32 depth;
+  u32 height;
+  std::vector<voxel> voxels;
+  // sized for voxels when parsed and reused by every flood
+  mutable grid_search::engine<> flood{};
+
+  [[nodiscard]] constexpr inline u32 index(u32 x, u32 y, u32 z) const noexcept {
+    return (z * depth + y) * width + x;
+  }
+};
+
+//! flood the outside through the bucket-queue search engine
+struct search {
+  constexpr static std::string_view const name{"search"};
+};
+
+//! flood the outside with a hand-rolled FIFO
+struct queue {
+  constexpr static std::string_view const name{"queue"};
+};
+
 } // namespace day18
 
-using Day18 = Day<18, day18::grid_type, u32>;
+using Day18 = Day<18, day18::droplet, u32, u32, day18::search>;
+using Day18Queue = Day<18, day18::droplet, u32, u32, day18::queue>;
+
+template <>
+struct day_variants<Day18> {
+  using type = std::tuple<Day18, Day18Queue>;
+};
@@ -12,6 +12,22 @@ namespace day20 {
     list_type<i64> numbers;
     unsigned zero_index{0};
   };
+
+  //! flat id array shifted with memmove; O(n) per move
+  struct memmove {
+    constexpr static std::string_view const name{"memmove"};
+  };
+
+  //! implicit treap with parent links; O(log n) per move
+  struct tree {
+    constexpr static std::string_view const name{"tree"};
+  };
 }
 
-using Day20 = Day<20, day20::result, i64>;
+using Day20 = Day<20, day20::result, i64, i64, day20::memmove>;
+using Day20Tree = Day<20, day20::result, i64, i64, day20::tree>;
+
+template <>
+struct day_variants<Day20> {
+  using type = std::tuple<Day20, Day20Tree>;
+};
@@ -0,0 +1,28 @@
+#include <array>
+
+#include "days/day.hpp"
+
+namespace day24 {
+
+// one bit per column; bit 0 is the leftmost open column
+__extension__ typedef unsigned __int128 row_t;
+
+// rotating a row by the full width must stay a valid shift
+constexpr u32 const MAX_WIDTH{127};
+constexpr u32 const MAX_HEIGHT{64};
+
+using rows_t = std::array<row_t, MAX_HEIGHT>;
+
+struct basin {
+  // blizzard positions at minute 0, one bitset per row and direction
+  rows_t right{};
+  rows_t left{};
+  rows_t up{};
+  rows_t down{};
+  u32 width{0};
+  u32 height{0};
+};
+
+} // namespace day24
+
+using Day24 = Day<24, day24::basin, u32>;
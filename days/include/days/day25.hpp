@@ -0,0 +1,28 @@
+#include <string>
+
+#include "days/day.hpp"
+
+namespace day25 {
+
+// a million 20-digit SNAFU numbers overflow 64 bits
+__extension__ typedef __int128 sum_t;
+
+//! decode each line to an integer (Horner), then add
+struct horner {
+  constexpr static std::string_view const name{"horner"};
+};
+
+//! add digits column-wise aligned at the line ends, then fold the columns once
+struct columns {
+  constexpr static std::string_view const name{"columns"};
+};
+
+} // namespace day25
+
+using Day25 = Day<25, day25::sum_t, std::string, std::string_view, day25::horner>;
+using Day25Columns = Day<25, day25::sum_t, std::string, std::string_view, day25::columns>;
+
+template <>
+struct day_variants<Day25> {
+  using type = std::tuple<Day25, Day25Columns>;
+};
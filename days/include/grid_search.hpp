@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "types.hpp"
+
+namespace grid_search {
+
+//! One flag per node of a flat grid
+class node_set {
+public:
+  explicit inline node_set(u32 nodes) noexcept
+      : m_words((nodes + 63) / 64, 0LU) {
+  }
+
+  inline void clear() noexcept {
+    std::ranges::fill(m_words, 0LU);
+  }
+
+  [[nodiscard]] inline bool contains(u32 node) const noexcept {
+    return (m_words[node / 64] >> (node % 64)) & 1;
+  }
+
+  //! false if `node` was already present
+  inline bool insert(u32 node) noexcept {
+    u64 const bit{1LU << (node % 64)};
+    if (m_words[node / 64] & bit) {
+      return false;
+    }
+    m_words[node / 64] |= bit;
+    return true;
+  }
+
+private:
+  std::vector<u64> m_words;
+};
+
+//! Monotone priority queue over small integer priorities (Dial's algorithm)
+/*! A ring of buckets, Span to begin with, holds the priorities [current, current + ring size). A step that raises the
+ *  priority by less than Span always lands in that window; a push past it widens the ring to fit, and one below it
+ *  (only an inconsistent heuristic does that) is served next. Buckets keep their capacity across searches.
+ */
+template <u32 Span>
+class bucket_queue {
+public:
+  struct entry {
+    u32 node;
+    u32 cost;
+  };
+
+  inline bucket_queue() noexcept
+      : m_buckets(Span) {
+  }
+
+  //! empty the queue and open the window at priority `lowest`
+  inline void reset(u32 lowest) noexcept {
+    for (auto &bucket : m_buckets) {
+      bucket.clear();
+    }
+    m_current = lowest;
+    m_size = 0;
+  }
+
+  [[nodiscard]] inline bool empty() const noexcept {
+    return m_size == 0;
+  }
+
+  inline void push(u32 node, u32 cost, u32 priority) noexcept {
+    priority = std::max(priority, m_current);
+    if (priority - m_current >= std::size(m_buckets)) [[unlikely]] {
+      widen(priority - m_current + 1);
+    }
+    m_buckets[priority % std::size(m_buckets)].push_back({node, cost});
+    ++m_size;
+  }
+
+  //! an entry of the lowest priority; the queue must not be empty
+  [[nodiscard]] inline entry pop() noexcept {
+    while (m_buckets[m_current % std::size(m_buckets)].empty()) {
+      ++m_current;
+    }
+    auto &bucket = m_buckets[m_current % std::size(m_buckets)];
+    entry const result{bucket.back()};
+    bucket.pop_back();
+    --m_size;
+    return result;
+  }
+
+private:
+  //! regrow the ring to hold at least `span` priorities, moving every bucket to its priority's new place
+  void widen(usize span) {
+    std::vector<std::vector<entry>> wider(std::max(span, 2 * std::size(m_buckets)));
+    for (u32 p{m_current}; p < m_current + std::size(m_buckets); ++p) {
+      wider[p % std::size(wider)] = std::move(m_buckets[p % std::size(m_buckets)]);
+    }
+    m_buckets = std::move(wider);
+  }
+
+  std::vector<std::vector<entry>> m_buckets;
+  u32 m_current{0};
+  usize m_size{0};
+};
+
+//! Heuristic of an uninformed search
+struct no_heuristic {
+  [[nodiscard]] constexpr inline u32 operator()(u32) const noexcept {
+    return 0;
+  }
+};
+
+//! Cheapest-first search over the nodes [0, nodes) of a flat grid whose steps cost at most MaxStep
+/*! `neighbors(node, emit)` calls `emit(next)` or `emit(next, cost)` for every step out of `node`; grid bounds, walls and
+ *  anything to tally along the way are its business. `goal(node)` ends the search on the first node it accepts. With a
+ *  consistent `heuristic` this is A*; without one (and unit steps) it is a plain BFS that marks nodes when queued.
+ *  Every run starts afresh. The node set and the BFS queue are allocated up front, so a caller that keeps the engine
+ *  (next to its parsed input, say) runs every search without allocating; only the A* buckets grow on demand, and they
+ *  keep their capacity too.
+ */
+template <u32 MaxStep = 1>
+class engine {
+public:
+  engine() noexcept = default;
+
+  explicit inline engine(u32 nodes) noexcept
+      : m_settled{nodes},
+        m_fifo(MaxStep == 1 ? nodes : 0) {
+  }
+
+  //! cost of the cheapest path from any source to any goal, if one is reached
+  template <typename Neighbors, typename Goal, typename Heuristic = no_heuristic>
+  [[nodiscard]] std::optional<u32>
+  run(std::span<u32 const> sources, Neighbors &&neighbors, Goal &&goal, Heuristic &&heuristic = {}) noexcept {
+    m_settled.clear();
+    if constexpr (MaxStep == 1 and std::is_same_v<std::remove_cvref_t<Heuristic>, no_heuristic>) {
+      // breadth-first: a node is first queued at its final cost, so it is settled then and a FIFO of nodes replaces
+      // the buckets; every node is queued at most once
+      u32 *const fifo{std::data(m_fifo)};
+      u32 *back{fifo};
+      for (u32 source : sources) {
+        if (m_settled.insert(source)) {
+          *back++ = source;
+        }
+      }
+      // the cost rises by one each time the front passes the end of the previous level
+      u32 cost{0};
+      for (u32 const *front{fifo}, *level_end{back}; front != back; ++front) {
+        if (front == level_end) {
+          ++cost;
+          level_end = back;
+        }
+        if (goal(*front)) {
+          return cost;
+        }
+        neighbors(*front, [&](u32 next, [[maybe_unused]] u32 step = 1) noexcept {
+          if (m_settled.insert(next)) {
+            *back++ = next;
+          }
+        });
+      }
+    } else {
+      u32 lowest{~0u};
+      for (u32 source : sources) {
+        lowest = std::min(lowest, heuristic(source));
+      }
+      m_queue.reset(lowest);
+      for (u32 source : sources) {
+        m_queue.push(source, 0, heuristic(source));
+      }
+      while (not m_queue.empty()) {
+        auto const [node, cost] = m_queue.pop();
+        if (not m_settled.insert(node)) {
+          continue;
+        }
+        if (goal(node)) {
+          return cost;
+        }
+        neighbors(node, [&](u32 next, u32 step = 1) noexcept {
+          if (not m_settled.contains(next)) {
+            m_queue.push(next, cost + step, cost + step + heuristic(next));
+          }
+        });
+      }
+    }
+    return std::nullopt;
+  }
+
+private:
+  node_set m_settled{0};
+  // a consistent heuristic can raise the priority of a step by twice its cost
+  bucket_queue<2 * MaxStep + 1> m_queue;
+  // only the unit-step BFS uses it
+  std::vector<u32> m_fifo;
+};
+
+} // namespace grid_search
@@ -1,11 +1,83 @@
 #pragma once
 
+#include <array>
 #include <concepts>
+#include <utility>
 
 #include <fmt/core.h>
 
 #include "types.hpp"
 
+namespace letter_font {
+
+struct glyph {
+  u32 bits;
+  char symbol;
+};
+
+constexpr inline std::array<glyph, 23> const font{{
+    // test pattern
+    {0x3fffbcf3u, '!'},
+    {0x061061d9u, '@'},
+    {0x21cf8f8cu, '#'},
+    {0x3e707b06u, '$'},
+    {0x030fc233u, '%'},
+    {0x31f01c79u, '^'},
+    {0x3e0ff0ecu, '&'},
+    {0x01e005c6u, '*'},
+    // letters
+    {0x1297a526u, 'A'},
+    {0x0e949d27u, 'B'},
+    {0x0c908526u, 'C'},
+    {0x1e109c2fu, 'E'},
+    {0x02109c2fu, 'F'},
+    {0x1c968526u, 'G'},
+    {0x1294bd29u, 'H'},
+    {0x0c94210cu, 'J'},
+    {0x12528ca9u, 'K'},
+    {0x1e108421u, 'L'},
+    {0x0213a527u, 'P'},
+    {0x1253a527u, 'R'},
+    {0x0c94a529u, 'U'},
+    {0x1e11110fu, 'Z'},
+    // blank
+    {0x0u, ' '},
+}};
+
+constexpr inline u32 const slot_bits{6};
+
+//! Multiplicative hash that sends every glyph of the font to its own slot
+constexpr inline u32 const multiplier{[] {
+  for (u32 m{0x9E3779B1u};; m += 2) {
+    std::array<bool, 1u << slot_bits> used{};
+    bool collision{false};
+    for (glyph const &g : font) {
+      u32 const slot{(g.bits * m) >> (32 - slot_bits)};
+      collision |= std::exchange(used[slot], true);
+    }
+    if (not collision) {
+      return m;
+    }
+  }
+}()};
+
+[[nodiscard]] constexpr inline u32
+slot_of(u32 bits) noexcept {
+  return (bits * multiplier) >> (32 - slot_bits);
+}
+
+constexpr inline std::array<glyph, 1u << slot_bits> const table{[] {
+  // no 30-bit glyph matches an empty slot
+  std::array<glyph, 1u << slot_bits> result;
+  result.fill(glyph{~0u, '?'});
+  for (glyph const &g : font) {
+    result[slot_of(g.bits)] = g;
+  }
+  return result;
+}()};
+
+} // namespace letter_font
+
 struct letter {
   static constexpr inline u8 width{5};
   static constexpr inline u8 height{6};
@@ -35,62 +107,16 @@ struct letter {
     }
   }
 
+  //! Character drawn by a 5x6 glyph (bit r * width + c is row r, column c); ' ' when blank, '?' when unknown
+  [[nodiscard]] static constexpr inline char recognize(u32 bits) noexcept {
+    letter_font::glyph const &entry{letter_font::table[letter_font::slot_of(bits)]};
+    return (entry.bits == bits) ? entry.symbol : '?';
+  }
+
   template <typename T>
   constexpr inline T as() const noexcept {
     if constexpr (std::same_as<T, char>) {
-      switch (value) {
-      // test pattern
-      case 0x3fffbcf3u:
-        return '!';
-      case 0x061061d9u:
-        return '@';
-      case 0x21cf8f8cu:
-        return '#';
-      case 0x3e707b06u:
-        return '$';
-      case 0x030fc233u:
-        return '%';
-      case 0x31f01c79u:
-        return '^';
-      case 0x3e0ff0ecu:
-        return '&';
-      case 0x01e005c6u:
-        return '*';
-      // letters
-      case 0x1297a526u:
-        return 'A';
-      case 0x0e949d27u:
-        return 'B';
-      case 0x0c908526u:
-        return 'C';
-      case 0x1e109c2fu:
-        return 'E';
-      case 0x02109c2fu:
-        return 'F';
-      case 0x1c968526u:
-        return 'G';
-      case 0x1294bd29u:
-        return 'H';
-      case 0x0c94210cu:
-        return 'J';
-      case 0x12528ca9u:
-        return 'K';
-      case 0x1e108421u:
-        return 'L';
-      case 0x0213a527u:
-        return 'P';
-      case 0x1253a527u:
-        return 'R';
-      case 0x0c94a529u:
-        return 'U';
-      case 0x1e11110fu:
-        return 'Z';
-      // unknown
-      case 0x0:
-        return ' ';
-      default:
-        return '?';
-      }
+      return recognize(value);
     } else {
       return as<T>(value);
     }
@@ -0,0 +1,74 @@
+// Built once per day as dayNN.so when ADVENT_PLUGINS is enabled (see days/CMakeLists.txt).
+// ADVENT_PLUGIN_DAY names the Day<> alias and ADVENT_PLUGIN_HEADER its header.
+
+#include <algorithm>
+#include <optional>
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include ADVENT_PLUGIN_HEADER
+#include "plugin.hpp"
+
+using PluginDay = ADVENT_PLUGIN_DAY;
+
+struct advent_state {
+  PluginDay day;
+  std::optional<typename PluginDay::parse_result_t> parsed;
+  std::optional<typename PluginDay::part1_result_t> part1;
+  std::optional<typename PluginDay::part2_result_t> part2;
+};
+
+[[nodiscard]] static usize
+format_into(auto const &value, char *buffer, usize capacity) noexcept {
+  auto const result = fmt::format_to_n(buffer, capacity, FMT_COMPILE("{}"), value);
+  return result.size;
+}
+
+extern "C" {
+
+[[gnu::visibility("default")]] u32
+advent_plugin_abi() noexcept {
+  return advent_plugin_abi_version;
+}
+
+[[gnu::visibility("default")]] u32
+advent_plugin_day() noexcept {
+  return PluginDay::number;
+}
+
+[[gnu::visibility("default")]] advent_state *
+advent_plugin_create() noexcept {
+  return new advent_state{};
+}
+
+[[gnu::visibility("default")]] void
+advent_plugin_destroy(advent_state *state) noexcept {
+  delete state;
+}
+
+[[gnu::visibility("default")]] void
+advent_plugin_parse(advent_state *state, char const *input, usize length) noexcept {
+  state->parsed.emplace(state->day.parse_input(std::string_view{input, length}));
+}
+
+[[gnu::visibility("default")]] void
+advent_plugin_part1(advent_state *state) noexcept {
+  state->part1.emplace(state->day.part1(*state->parsed));
+}
+
+[[gnu::visibility("default")]] void
+advent_plugin_part2(advent_state *state) noexcept {
+  state->part2.emplace(state->day.part2(*state->parsed, state->part1));
+}
+
+[[gnu::visibility("default")]] usize
+advent_plugin_format(advent_state const *state, u32 part, char *buffer, usize capacity) noexcept {
+  if (part == 1 and state->part1.has_value()) {
+    return format_into(*state->part1, buffer, capacity);
+  } else if (part == 2 and state->part2.has_value()) {
+    return format_into(*state->part2, buffer, capacity);
+  }
+  return 0;
+}
+}
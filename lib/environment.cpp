@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fmt/compile.h>
+#include <fmt/core.h>
+
+#if __linux__
+#include <sched.h>
+#endif
+
+#include "environment.hpp"
+
+[[nodiscard]] static std::string
+read_first_line(std::string const &path) noexcept {
+  std::string line;
+  if (FILE *file = fopen(path.c_str(), "r"); file != nullptr) {
+    char buffer[256];
+    if (fgets(buffer, sizeof(buffer), file) != nullptr) {
+      line = buffer;
+      while (not line.empty() and (line.back() == '\n' or line.back() == ' ')) {
+        line.pop_back();
+      }
+    }
+    (void)fclose(file);
+  }
+  return line;
+}
+
+[[nodiscard]] static std::string
+cpuinfo_value(std::string_view key) noexcept {
+  std::string value;
+  if (FILE *file = fopen("/proc/cpuinfo", "r"); file != nullptr) {
+    char buffer[512];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+      std::string_view const line{buffer};
+      if (not line.starts_with(key)) {
+        continue;
+      }
+      if (auto const colon = line.find(':'); colon != std::string_view::npos) {
+        std::string_view v{line.substr(colon + 1)};
+        while (not v.empty() and (v.front() == ' ' or v.front() == '\t')) {
+          v.remove_prefix(1);
+        }
+        while (not v.empty() and (v.back() == '\n' or v.back() == ' ')) {
+          v.remove_suffix(1);
+        }
+        value = v;
+        break;
+      }
+    }
+    (void)fclose(file);
+  }
+  return value;
+}
+
+[[nodiscard]] static std::string
+governor_of(u32 cpu) noexcept {
+  return read_first_line(fmt::format(FMT_COMPILE("/sys/devices/system/cpu/cpu{}/cpufreq/scaling_governor"), cpu));
+}
+
+[[nodiscard]] std::optional<std::vector<u32>>
+parse_cpu_list(std::string_view list) noexcept {
+  std::vector<u32> cpus;
+  while (not list.empty()) {
+    std::string_view const item{list.substr(0, list.find(','))};
+    list.remove_prefix(std::min(list.size(), item.size() + 1));
+    auto const dash = item.find('-');
+    std::string const first{item.substr(0, dash)};
+    std::string const last{dash == std::string_view::npos ? first : std::string{item.substr(dash + 1)}};
+    if (first.empty() or last.empty()) {
+      return std::nullopt;
+    }
+    char *end{nullptr};
+    u32 const lo{as<u32>(strtoul(first.c_str(), &end, 10))};
+    if (*end != '\0') {
+      return std::nullopt;
+    }
+    u32 const hi{as<u32>(strtoul(last.c_str(), &end, 10))};
+    if (*end != '\0' or hi < lo) {
+      return std::nullopt;
+    }
+    for (u32 cpu{lo}; cpu <= hi; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    return std::nullopt;
+  }
+  return cpus;
+}
+
+[[nodiscard]] bool
+pin_current_thread(std::span<u32 const> cpus) noexcept {
+  if (cpus.empty()) {
+    return true;
+  }
+#if __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (u32 const cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+[[nodiscard]] bool
+request_realtime() noexcept {
+#if __linux__
+  sched_param param{};
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  return sched_setscheduler(0, SCHED_FIFO, &param) == 0;
+#else
+  return false;
+#endif
+}
+
+[[nodiscard]] bool
+governors_are_performance(std::span<u32 const> cpus) noexcept {
+  if (cpus.empty()) {
+    std::string const governor{governor_of(0)};
+    return governor.empty() or governor == "performance";
+  }
+  for (u32 const cpu : cpus) {
+    // no cpufreq driver (VMs, containers) means nothing to check
+    if (std::string const governor{governor_of(cpu)}; not governor.empty() and governor != "performance") {
+      return false;
+    }
+  }
+  return true;
+}
+
+[[nodiscard]] run_environment
+capture_environment(std::span<u32 const> cpus, bool realtime) noexcept {
+  run_environment env;
+  u32 const cpu{cpus.empty() ? 0u : cpus.front()};
+  env.cpu_model = cpuinfo_value("model name");
+  env.governor = governor_of(cpu);
+  if (std::string const khz{read_first_line(
+          fmt::format(FMT_COMPILE("/sys/devices/system/cpu/cpu{}/cpufreq/scaling_cur_freq"), cpu))};
+      not khz.empty()) {
+    env.cpu_mhz = strtod(khz.c_str(), nullptr) / 1000.0;
+  } else if (std::string const mhz{cpuinfo_value("cpu MHz")}; not mhz.empty()) {
+    env.cpu_mhz = strtod(mhz.c_str(), nullptr);
+  }
+  if (std::string const smt{read_first_line("/sys/devices/system/cpu/smt/active")}; not smt.empty()) {
+    env.smt_active = (smt == "1");
+  }
+  env.affinity.assign(std::begin(cpus), std::end(cpus));
+  env.realtime = realtime;
+  return env;
+}
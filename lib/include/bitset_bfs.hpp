@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "types.hpp"
+
+//! Breadth-first search over a grid whose frontier is a bitset
+/*! The grid is one row-major bit string with a blank guard column after every row. Which cells may be entered from
+ *  which neighbor is decided once, up front, as one mask per direction; a search step then moves the whole frontier
+ *  with word-wide shifts (by one bit sideways, by a row's stride vertically), keeps what those masks allow and drops
+ *  visited cells. Searches start from any number of sources and stop at the first of any number of targets.
+ */
+class bitset_bfs {
+public:
+  //! One bit per cell
+  class cell_set {
+  public:
+    inline void set(u32 x, u32 y) noexcept {
+      usize const bit{m_origin + as<usize>(y) * m_stride + x};
+      m_words[bit / 64] |= 1LU << (bit % 64);
+    }
+
+    [[nodiscard]] inline bool test(u32 x, u32 y) const noexcept {
+      usize const bit{m_origin + as<usize>(y) * m_stride + x};
+      return (m_words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+  private:
+    friend class bitset_bfs;
+
+    //! ORs in row y from one 0/1 byte per cell, eight cells at a time
+    inline void or_row(u32 y, std::span<u8 const> cells) noexcept {
+      usize bit{m_origin + as<usize>(y) * m_stride};
+      for (usize x{0}; x < std::size(cells); x += 8, bit += 8) {
+        u64 bytes;
+        std::memcpy(&bytes, std::data(cells) + x, sizeof(bytes));
+        // gathers the low bit of each byte into the top byte, first cell lowest
+        u64 const bits{(bytes * 0x0102040810204080LU) >> 56};
+        m_words[bit / 64] |= bits << (bit % 64);
+        if (bit % 64 > 56) {
+          m_words[bit / 64 + 1] |= bits >> (64 - bit % 64);
+        }
+      }
+    }
+
+    cell_set(usize stride, usize origin, usize words) noexcept
+        : m_stride{stride},
+          m_origin{origin},
+          m_words(words, 0LU) {
+    }
+
+    usize m_stride;
+    usize m_origin;
+    std::vector<u64> m_words;
+  };
+
+  //! can_step(from, to) says whether a cell with value `from` may step onto a neighbor with value `to`; row y of the
+  //! grid is cells[y * stride, y * stride + width)
+  template <typename T, typename CanStep>
+  bitset_bfs(std::span<T const> cells, u32 width, u32 height, usize stride, CanStep &&can_step) noexcept
+      : m_width{width},
+        m_height{height},
+        // the guard column keeps sideways shifts from wrapping into the next row; a stride that is a whole number
+        // of words would make the vertical shift a special case, so it gets a second guard column
+        m_stride{(width + 1) % 64 == 0 ? width + 2 : width + 1},
+        m_row_words{m_stride / 64},
+        m_row_bits{m_stride % 64},
+        // blank words before and after the grid let every shift read its neighbors unchecked
+        m_padding{m_row_words + 2},
+        m_words{(as<usize>(height) * m_stride + 63) / 64 + 2 * m_padding},
+        m_from_west{make_set()},
+        m_from_east{make_set()},
+        m_from_north{make_set()},
+        m_from_south{make_set()} {
+    // one byte per cell of a row, rounded up to whole bytes of eight cells; the comparisons vectorize
+    std::vector<u8> allowed((width + 7) / 8 * 8, 0);
+    auto const fill = [&](cell_set &mask, u32 y, T const *row, isize neighbor, u32 begin, u32 end) noexcept {
+      for (u32 x{begin}; x < end; ++x) {
+        allowed[x] = can_step(row[as<isize>(x) + neighbor], row[x]);
+      }
+      mask.or_row(y, allowed);
+      std::fill(std::begin(allowed), std::end(allowed), u8{0});
+    };
+    isize const down{as<isize>(stride)};
+    for (u32 y{0}; y < height; ++y) {
+      T const *row{std::data(cells) + y * stride};
+      fill(m_from_west, y, row, -1, 1, width);
+      fill(m_from_east, y, row, 1, 0, width - 1);
+      if (y > 0) {
+        fill(m_from_north, y, row, -down, 0, width);
+      }
+      if (y + 1 < height) {
+        fill(m_from_south, y, row, down, 0, width);
+      }
+    }
+  }
+
+  [[nodiscard]] inline cell_set make_set() const noexcept {
+    return cell_set{m_stride, m_padding * 64, m_words};
+  }
+
+  //! Steps from the nearest source to the nearest target, if any target can be reached
+  [[nodiscard]] std::optional<u32> distance(cell_set const &sources, cell_set const &targets) const noexcept {
+    std::vector<u64> frontier{sources.m_words}, visited{sources.m_words}, next(m_words, 0LU);
+    usize const q{m_row_words}, r{m_row_bits};
+    // words of the frontier that may be non-zero
+    usize first{m_padding}, last{m_words - m_padding - 1};
+    for (u32 steps{0};; ++steps) {
+      while (first <= last and frontier[first] == 0) {
+        ++first;
+      }
+      while (last >= first and frontier[last] == 0) {
+        --last;
+      }
+      if (first > last) {
+        return std::nullopt;
+      }
+      // a step reaches at most one row (plus a word for the leftover bits) past the frontier
+      usize const lo{std::max(first - q - 1, m_padding)}, hi{std::min(last + q + 1, m_words - m_padding - 1)};
+      u64 found{0};
+      for (usize i{first}; i <= last; ++i) {
+        found |= frontier[i] & targets.m_words[i];
+      }
+      if (found != 0) {
+        return steps;
+      }
+      for (usize i{lo}; i <= hi; ++i) {
+        u64 const from_west{(frontier[i] << 1) | (frontier[i - 1] >> 63)};
+        u64 const from_east{(frontier[i] >> 1) | (frontier[i + 1] << 63)};
+        u64 const from_north{(frontier[i - q] << r) | (frontier[i - q - 1] >> (64 - r))};
+        u64 const from_south{(frontier[i + q] >> r) | (frontier[i + q + 1] << (64 - r))};
+        u64 const reached{(from_west & m_from_west.m_words[i]) | (from_east & m_from_east.m_words[i]) |
+                          (from_north & m_from_north.m_words[i]) | (from_south & m_from_south.m_words[i])};
+        next[i] = reached & ~visited[i];
+        visited[i] |= next[i];
+      }
+      // the old frontier becomes the next buffer and must be blank outside the range written above
+      std::fill(std::begin(frontier) + as<isize>(first), std::begin(frontier) + as<isize>(last) + 1, 0LU);
+      std::swap(frontier, next);
+      first = lo;
+      last = hi;
+    }
+  }
+
+  [[nodiscard]] inline u32 width() const noexcept {
+    return m_width;
+  }
+
+  [[nodiscard]] inline u32 height() const noexcept {
+    return m_height;
+  }
+
+private:
+  u32 m_width;
+  u32 m_height;
+  // bits per grid row, as whole words plus leftover bits
+  usize m_stride;
+  usize m_row_words;
+  usize m_row_bits;
+  usize m_padding;
+  usize m_words;
+  // cells that may be entered from their west, east, north and south neighbor
+  cell_set m_from_west;
+  cell_set m_from_east;
+  cell_set m_from_north;
+  cell_set m_from_south;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <span>
+
+#include "types.hpp"
+
+//! End offset of the first run of `window` pairwise distinct bytes in data
+/*! A sliding window keeps a count per byte value and the number of values that occur more than once. Each new byte
+ *  joins at the end; while it leaves a repeat, the start skips forward past the earlier copy. Every byte enters and
+ *  leaves the window at most once, so this is O(n) whatever the window and the input.
+ */
+[[nodiscard]] inline std::optional<usize>
+first_distinct_window(std::span<u8 const> data, usize window) noexcept {
+  if (window == 0) {
+    return 0;
+  }
+  std::array<u32, 256> count{};
+  u32 repeats{0};
+  for (usize start{0}, end{0}; end < std::size(data);) {
+    repeats += (++count[data[end++]] == 2);
+    while (repeats != 0) {
+      repeats -= (--count[data[start++]] == 1);
+    }
+    if (end - start == window) {
+      return end;
+    }
+  }
+  return std::nullopt;
+}
+
+//! first_distinct_window for symbols that are distinct modulo 32 (such as 'a'-'z'), eight window ends per step
+/*! Symbols become one-hot bits and a window's XOR keeps exactly `window` bits only if no symbol repeats in it.
+ *  Running prefix XORs are built eight at a time (in-register scan plus carry), and the window XORs for eight ends
+ *  are one vector XOR against the prefixes `window` positions back, kept in a small ring. Windows wider than 32, and
+ *  data with bytes outside the 32-symbol block of its first byte, go to first_distinct_window instead.
+ */
+[[nodiscard]] inline std::optional<usize>
+first_distinct_window_letters(std::span<u8 const> data, usize window) noexcept {
+  constexpr usize const lanes{8};
+  // power of two, and covers window + lanes for every window that can be distinct
+  constexpr usize const ring{64};
+  typedef u8 bytes_t __attribute__((vector_size(lanes)));
+  typedef u32 sets_t __attribute__((vector_size(lanes * sizeof(u32))));
+  typedef i32 index_t __attribute__((vector_size(lanes * sizeof(i32))));
+
+  if (window == 0 or window > 32 or std::empty(data)) {
+    return first_distinct_window(data, window);
+  }
+  // symbols are distinct modulo 32 when they all share the upper three bits
+  bytes_t const block{(bytes_t{} + data[0]) & 0xE0};
+  // prefix[k] holds the XOR of data[0, k + 1); every block is written twice so loads never wrap
+  alignas(32) std::array<u32, 2 * ring> prefix{};
+  sets_t const zero{};
+  u32 carry{0};
+  usize i{0};
+  for (; i + lanes <= std::size(data); i += lanes) {
+    bytes_t symbols;
+    std::memcpy(&symbols, std::data(data) + i, sizeof(symbols));
+    if (std::bit_cast<u64>((symbols & 0xE0) ^ block) != 0) {
+      return first_distinct_window(data, window);
+    }
+    sets_t p{(sets_t{} + 1) << (__builtin_convertvector(symbols, sets_t) & 31)};
+    p ^= __builtin_shuffle(p, zero, index_t{8, 0, 1, 2, 3, 4, 5, 6});
+    p ^= __builtin_shuffle(p, zero, index_t{8, 8, 0, 1, 2, 3, 4, 5});
+    p ^= __builtin_shuffle(p, zero, index_t{8, 8, 8, 8, 0, 1, 2, 3});
+    p ^= carry;
+    carry = p[lanes - 1];
+    std::memcpy(std::data(prefix) + (i % ring), &p, sizeof(p));
+    std::memcpy(std::data(prefix) + (i % ring) + ring, &p, sizeof(p));
+    if (i + lanes < window) {
+      continue;
+    }
+    // lane l covers the window ending at i + l + 1; before the first full window the ring still holds zeros
+    sets_t back;
+    std::memcpy(&back, std::data(prefix) + ((i + ring - window) % ring), sizeof(back));
+    sets_t const sets{p ^ back};
+    for (usize l{(i + 1 < window) ? window - i - 1 : 0}; l < lanes; ++l) {
+      if (std::popcount(sets[l]) == as<int>(window)) {
+        return i + l + 1;
+      }
+    }
+  }
+  usize const resume{i >= window ? i - window + 1 : 0};
+  if (auto const rest = first_distinct_window(data.subspan(resume), window); rest.has_value()) {
+    return resume + *rest;
+  }
+  return std::nullopt;
+}
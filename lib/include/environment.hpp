@@ -0,0 +1,37 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "types.hpp"
+
+struct run_environment {
+  std::string cpu_model{};
+  double cpu_mhz{0.0};
+  std::string governor{};
+  std::optional<bool> smt_active{std::nullopt};
+  std::vector<u32> affinity{};
+  bool realtime{false};
+};
+
+//! Parse a CPU list of the form "0-3,6,8" into individual CPU ids
+[[nodiscard]] std::optional<std::vector<u32>>
+parse_cpu_list(std::string_view list) noexcept;
+
+//! Pin the calling thread to the given CPUs (all CPUs when empty)
+[[nodiscard]] bool
+pin_current_thread(std::span<u32 const> cpus) noexcept;
+
+//! Request SCHED_FIFO for the calling thread; fails without CAP_SYS_NICE
+[[nodiscard]] bool
+request_realtime() noexcept;
+
+//! Returns true when every CPU in the set uses the "performance" governor
+[[nodiscard]] bool
+governors_are_performance(std::span<u32 const> cpus) noexcept;
+
+[[nodiscard]] run_environment
+capture_environment(std::span<u32 const> cpus, bool realtime) noexcept;
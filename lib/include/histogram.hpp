@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include "meta/utils.hpp"
+#include "types.hpp"
+
+//! Counts fixed-width records by exact (masked) match against N known patterns
+/*! Every Lane-sized record of the input is compared against each pattern a whole vector of records at a time.
+ *  Each pattern owns a vector of per-lane counters (its own sub-histogram), so there is no scatter and no
+ *  store-to-load dependency between consecutive records; the lanes are reduced once at the end.
+ *  Only bytes set in mask take part in the comparison, which keeps separators (and a missing final one) out of it.
+ *  Records matching no pattern are not counted.
+ */
+template <std::unsigned_integral Lane, usize N>
+[[nodiscard]] std::array<u32, N>
+count_records(std::string_view view, std::array<Lane, N> const &patterns, Lane mask) noexcept {
+  constexpr usize const vector_bytes{32};
+  constexpr usize const lanes{vector_bytes / sizeof(Lane)};
+  // narrow lanes must be drained before their counters wrap
+  constexpr usize const flush_every{std::min<usize>(std::numeric_limits<Lane>::max(), 1LU << 24)};
+  typedef Lane vector_t __attribute__((vector_size(vector_bytes)));
+
+  std::array<u32, N> result{};
+  // a plain array: std::array would drop the vector attribute from its element type
+  vector_t counters[N]{};
+  auto const drain = [&] {
+    for (usize p{0}; p < N; ++p) {
+      for (usize l{0}; l < lanes; ++l) {
+        result[p] += as<u32>(counters[p][l]);
+      }
+      counters[p] = vector_t{};
+    }
+  };
+
+  vector_t const vmask = vector_t{} + mask;
+  vector_t broadcast[N];
+  for (usize p{0}; p < N; ++p) {
+    broadcast[p] = vector_t{} + patterns[p];
+  }
+  char const *curr{std::data(view)};
+  usize remaining{std::size(view)};
+  for (usize block{0}; remaining >= vector_bytes; curr += vector_bytes, remaining -= vector_bytes) {
+    vector_t records;
+    std::memcpy(&records, curr, vector_bytes);
+    records &= vmask;
+    // unrolled so the counters stay in registers; a true comparison is all ones, i.e. -1 per matching lane
+    static_for<N>([&]<usize P>(constant_t<P>) {
+      counters[P] -= reinterpret_cast<vector_t>(records == broadcast[P]);
+    });
+    if (++block == flush_every) {
+      drain();
+      block = 0;
+    }
+  }
+  drain();
+
+  for (; remaining > 0; curr += std::min(remaining, sizeof(Lane)), remaining -= std::min(remaining, sizeof(Lane))) {
+    Lane record{0};
+    std::memcpy(&record, curr, std::min(remaining, sizeof(Lane)));
+    for (usize p{0}; p < N; ++p) {
+      result[p] += as<u32>((record & mask) == patterns[p]);
+    }
+  }
+  return result;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "environment.hpp"
+#include "options.hpp"
+#include "table.hpp"
+#include "timing.hpp"
+
+void
+json_output(run_options const &options,
+            run_environment const &environment,
+            report_timing const &timing,
+            report_data const &entries,
+            timing_data const &summary) noexcept;
@@ -5,6 +5,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <fmt/core.h>
 
@@ -19,6 +20,8 @@ struct run_options {
   std::optional<u32> graph_width{std::nullopt};
   std::optional<u32> single{std::nullopt};
   std::optional<u32> benchmark{std::nullopt};
+  std::vector<u32> affinity{};
+  std::optional<std::string> variant{std::nullopt};
 
   bool timing{true};
   bool part2{true};
@@ -28,6 +31,10 @@ struct run_options {
   bool colorize{true};
   bool graphs{false};
   bool visual{false};
+  bool realtime{false};
+  bool interleave{false};
+  bool json{false};
+  bool all_variants{false};
 
   [[nodiscard]] inline std::string format(std::integral auto value) const noexcept {
     return fmt::format("{0}", value);
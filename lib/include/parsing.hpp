@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <cstring>
 #include <numeric>
 #include <string_view>
 #include <tuple>
@@ -9,6 +10,7 @@
 
 #include "fixed_string.hpp"
 #include "meta/utils.hpp"
+#include "types.hpp"
 
 constexpr inline std::string_view
 unsafe_substr(std::string_view str, std::unsigned_integral auto offset) noexcept {
@@ -63,6 +65,21 @@ parse(std::string_view s) noexcept requires(not std::same_as<T, char>) {
   }
 }
 
+//! Decode 1 to 8 ASCII digits at once: place them at the top of a u64, then combine pairs, quads and octets
+/*! \note reads 8 bytes from s.data(), so at least 8 bytes must be addressable there
+ */
+[[gnu::always_inline, nodiscard]] inline u32
+parse_digits8(std::string_view s) noexcept {
+  u64 chunk;
+  std::memcpy(&chunk, std::data(s), sizeof(chunk));
+  // bytes past the digits may underflow here, but the shift drops them
+  chunk = (chunk - 0x3030303030303030LU) << (8 * (8 - std::size(s)));
+  chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFLU;
+  chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFLU;
+  chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFLU;
+  return as<u32>(chunk);
+}
+
 template <fixed_string FormatStr, typename... Ts>
 [[gnu::always_inline, gnu::flatten, nodiscard]] inline std::size_t
 parse(std::string_view view, Ts &...vals) noexcept {
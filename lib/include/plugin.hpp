@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#include "timing.hpp"
+#include "types.hpp"
+
+//! C ABI exported by every day plugin (days/plugin.cpp)
+extern "C" {
+struct advent_state;
+
+constexpr inline u32 const advent_plugin_abi_version{1};
+
+using advent_plugin_abi_fn = u32 (*)() noexcept;
+using advent_plugin_day_fn = u32 (*)() noexcept;
+using advent_plugin_create_fn = advent_state *(*)() noexcept;
+using advent_plugin_destroy_fn = void (*)(advent_state *) noexcept;
+using advent_plugin_parse_fn = void (*)(advent_state *, char const *input, usize length) noexcept;
+using advent_plugin_solve_fn = void (*)(advent_state *) noexcept;
+//! Writes part (1 or 2) into buffer, returns the full length (which may exceed capacity)
+using advent_plugin_format_fn = usize (*)(advent_state const *, u32 part, char *buffer, usize capacity) noexcept;
+}
+
+//! A day loaded from a shared object, reloadable when the file on disk changes
+class day_plugin {
+public:
+  explicit day_plugin(std::string path) noexcept;
+
+  ~day_plugin() noexcept;
+
+  day_plugin(day_plugin const &) = delete;
+  day_plugin &operator=(day_plugin const &) = delete;
+
+  operator bool() const noexcept;
+
+  //! Returns true when the shared object changed on disk and was reloaded
+  [[nodiscard]] bool reload_if_changed() noexcept;
+
+  [[nodiscard]] timing_data run(std::string_view input) noexcept;
+
+  [[nodiscard]] std::string answer(u32 part) const noexcept;
+
+  [[nodiscard]] u32 day() const noexcept;
+
+  [[nodiscard]] std::string const &path() const noexcept;
+
+private:
+  bool load() noexcept;
+  void unload() noexcept;
+
+  std::string m_path;
+  timespec m_modified{};
+  void *m_handle{nullptr};
+  advent_state *m_state{nullptr};
+  advent_plugin_day_fn m_day{nullptr};
+  advent_plugin_create_fn m_create{nullptr};
+  advent_plugin_destroy_fn m_destroy{nullptr};
+  advent_plugin_parse_fn m_parse{nullptr};
+  advent_plugin_solve_fn m_part1{nullptr};
+  advent_plugin_solve_fn m_part2{nullptr};
+  advent_plugin_format_fn m_format{nullptr};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "timing.hpp"
+#include "types.hpp"
+
+namespace server {
+
+// frames are host-endian; the socket never leaves the machine
+constexpr inline u32 const magic{0x32434f41}; // "AOC2"
+// the largest request accepted; generous for puzzle inputs, even scaled-up ones
+constexpr inline u32 const max_payload{16u << 20};
+constexpr inline usize const arena_size{1u << 20};
+
+enum class payload_kind : u8 { bytes = 0, path = 1 };
+
+enum class status : u32 { ok = 0, bad_request = 1, unknown_day = 2, no_input = 3 };
+
+struct request_header {
+  u32 magic{server::magic};
+  u8 day{0};
+  payload_kind kind{payload_kind::bytes};
+  u16 reserved{0};
+  u32 length{0};
+};
+
+struct reply_header {
+  u32 magic{server::magic};
+  status code{status::ok};
+  double parsing{0.0};
+  double part1{0.0};
+  double part2{0.0};
+  u32 part1_length{0};
+  u32 part2_length{0};
+};
+
+struct reply {
+  status code{status::ok};
+  timing_data timing{};
+  std::string part1{};
+  std::string part2{};
+};
+
+using handler_t = reply (*)(u32 day, std::string_view input) noexcept;
+
+//! Bind a Unix socket at path and answer requests with a pool of workers; worker w is pinned to cpus[w % size].
+/*! \note only returns on failure to set up the socket
+ */
+[[nodiscard]] bool
+listen_and_serve(std::string const &path, handler_t handler, std::span<u32 const> cpus, u32 workers) noexcept;
+
+[[nodiscard]] int
+connect_to(std::string const &path) noexcept;
+
+[[nodiscard]] bool
+send_request(int fd, u32 day, payload_kind kind, std::string_view payload) noexcept;
+
+[[nodiscard]] bool
+receive_reply(int fd, reply &result) noexcept;
+
+} // namespace server
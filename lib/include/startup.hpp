@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+
+#include "timing.hpp"
+
+//! Startup milestones for measuring time-to-first-solve.
+/*! first_initializer is captured by a priority-101 constructor, so it runs after exec, the dynamic loader and
+ *  shared-library initializers, but before any other static initializer of the executable.
+ */
+struct startup_profile {
+  std::chrono::system_clock::time_point first_initializer_wall{};
+  clock_type::time_point first_initializer{};
+  clock_type::time_point main_entry{};
+  clock_type::time_point options_parsed{};
+  clock_type::time_point first_solve{};
+  clock_type::time_point all_solved{};
+
+  //! Print the breakdown to stderr; exec + loading is reported when ADVENT_LAUNCH_NS holds the launch time
+  void report() const noexcept;
+};
+
+extern startup_profile startup;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <span>
+
+#include "types.hpp"
+
+//! Streaming accumulator for the K largest values seen so far
+/*! Small K keeps a descending array and inserts through a fixed compare-exchange chain (min/max, no branches);
+ *  larger K keeps a min-heap whose root is the current cutoff, so rejected values cost a single compare.
+ */
+template <typename T, usize K>
+class top_k {
+  static_assert(K > 0, "top_k needs room for at least one value");
+
+public:
+  //! largest K handled by the compare-exchange chain
+  constexpr static usize const network_limit{16};
+  constexpr static bool const uses_network{K <= network_limit};
+
+  constexpr inline void push(T value) noexcept {
+    if constexpr (uses_network) {
+      for (T &held : m_values) {
+        T const hi{std::max(held, value)};
+        value = std::min(held, value);
+        held = hi;
+      }
+      m_count += (m_count < K);
+    } else if (m_count < K) {
+      m_values[m_count++] = value;
+      std::push_heap(std::begin(m_values), std::begin(m_values) + m_count, std::greater<>{});
+    } else if (value > m_values[0]) {
+      std::pop_heap(std::begin(m_values), std::end(m_values), std::greater<>{});
+      m_values[K - 1] = value;
+      std::push_heap(std::begin(m_values), std::end(m_values), std::greater<>{});
+    }
+  }
+
+  //! number of values held (less than K only until K values were pushed)
+  [[nodiscard]] constexpr inline usize size() const noexcept {
+    return m_count;
+  }
+
+  //! held values, largest first
+  [[nodiscard]] constexpr inline std::array<T, K> sorted() const noexcept {
+    std::array<T, K> result{m_values};
+    if constexpr (not uses_network) {
+      std::sort(std::begin(result), std::begin(result) + m_count, std::greater<>{});
+    }
+    return result;
+  }
+
+  //! the largest value seen
+  [[nodiscard]] constexpr inline T front() const noexcept {
+    if constexpr (uses_network) {
+      return m_values[0];
+    } else {
+      return *std::max_element(std::begin(m_values), std::begin(m_values) + m_count);
+    }
+  }
+
+  [[nodiscard]] constexpr inline T sum() const noexcept {
+    return std::accumulate(std::begin(m_values), std::begin(m_values) + m_count, T{});
+  }
+
+private:
+  //! the chain compares against every slot, so unfilled slots hold the lowest value and sink below any real one
+  [[nodiscard]] constexpr static inline std::array<T, K> initial_values() noexcept {
+    std::array<T, K> result{};
+    if constexpr (uses_network) {
+      result.fill(std::numeric_limits<T>::lowest());
+    }
+    return result;
+  }
+
+  std::array<T, K> m_values{initial_values()};
+  usize m_count{0};
+};
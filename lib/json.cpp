@@ -0,0 +1,87 @@
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fmt/compile.h>
+#include <fmt/core.h>
+
+#include "json.hpp"
+
+[[nodiscard]] static std::string
+quoted(std::string_view value) noexcept {
+  std::string result{'"'};
+  for (char const c : value) {
+    if (as<u8>(c) < 0x20) {
+      // control characters may not appear raw in a JSON string
+      result += fmt::format(FMT_COMPILE("\\u{:04x}"), as<u8>(c));
+      continue;
+    }
+    if (c == '"' or c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  result += '"';
+  return result;
+}
+
+void
+json_output(run_options const &options,
+            run_environment const &environment,
+            report_timing const &timing,
+            report_data const &entries,
+            timing_data const &summary) noexcept {
+  fmt::print("{{\n  \"environment\": {{\n");
+  fmt::print(FMT_COMPILE("    \"cpu_model\": {},\n"), quoted(environment.cpu_model));
+  fmt::print(FMT_COMPILE("    \"cpu_mhz\": {:.1f},\n"), environment.cpu_mhz);
+  fmt::print(FMT_COMPILE("    \"governor\": {},\n"), quoted(environment.governor));
+  if (environment.smt_active.has_value()) {
+    fmt::print(FMT_COMPILE("    \"smt_active\": {},\n"), environment.smt_active.value());
+  } else {
+    fmt::print("    \"smt_active\": null,\n");
+  }
+  fmt::print("    \"affinity\": [");
+  for (usize i{0}; i < std::size(environment.affinity); ++i) {
+    fmt::print(FMT_COMPILE("{}{}"), (i == 0 ? "" : ", "), environment.affinity[i]);
+  }
+  fmt::print(FMT_COMPILE("],\n    \"sched_fifo\": {}\n  }},\n"), environment.realtime);
+  fmt::print(FMT_COMPILE("  \"repetitions\": {},\n  \"interleaved\": {},\n"),
+             options.benchmark.value_or(1),
+             options.interleave);
+
+  fmt::print("  \"days\": [");
+  bool first{true};
+  for (usize i{0}; i < std::size(entries); ++i) {
+    auto const &entry = entries[i];
+    if (entry[std::to_underlying(index::day)].empty()) {
+      continue;
+    }
+    fmt::print(FMT_COMPILE("{}\n    {{\"day\": {}"), (first ? "" : ","), quoted(entry[std::to_underlying(index::day)]));
+    first = false;
+    if (options.answers) {
+      if (options.part1) {
+        fmt::print(FMT_COMPILE(", \"part1\": {}"), quoted(entry[std::to_underlying(index::part1_answer)]));
+      }
+      if (options.part2) {
+        fmt::print(FMT_COMPILE(", \"part2\": {}"), quoted(entry[std::to_underlying(index::part2_answer)]));
+      }
+    }
+    if (options.timing) {
+      fmt::print(FMT_COMPILE(", \"parse_us\": {}, \"part1_us\": {}, \"part2_us\": {}, \"total_us\": {}"),
+                 timing[i].parsing,
+                 timing[i].part1,
+                 timing[i].part2,
+                 timing[i].total());
+    }
+    fmt::print("}}");
+  }
+  fmt::print("\n  ]");
+  if (options.timing) {
+    fmt::print(FMT_COMPILE(",\n  \"summary\": {{\"parse_us\": {}, \"part1_us\": {}, \"part2_us\": {}, \"total_us\": {}}}"),
+               summary.parsing,
+               summary.part1,
+               summary.part2,
+               summary.total());
+  }
+  fmt::print("\n}}\n");
+}
@@ -43,5 +43,25 @@ run_options::validate() const noexcept {
     (void)fprintf(stderr, "Cannot specify execution of single day with visual timing\n");
     valid = false;
   }
+  if (interleave and not benchmark) {
+    (void)fprintf(stderr, "Cannot interleave repetitions when not benchmarking\n");
+    valid = false;
+  }
+  if (interleave and single.has_value()) {
+    (void)fprintf(stderr, "Cannot interleave repetitions of a single day\n");
+    valid = false;
+  }
+  if (json and (visual or graphs)) {
+    (void)fprintf(stderr, "Cannot combine JSON output with visual timing or graph output\n");
+    valid = false;
+  }
+  if (all_variants and variant.has_value()) {
+    (void)fprintf(stderr, "Cannot select a variant when comparing all variants\n");
+    valid = false;
+  }
+  if (all_variants and (json or visual or graphs)) {
+    (void)fprintf(stderr, "Cannot combine variant comparison with JSON, visual or graph output\n");
+    valid = false;
+  }
   return valid;
 }
@@ -0,0 +1,155 @@
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "plugin.hpp"
+
+[[nodiscard]] static bool
+same_time(timespec const &a, timespec const &b) noexcept {
+  return a.tv_sec == b.tv_sec and a.tv_nsec == b.tv_nsec;
+}
+
+[[nodiscard]] static bool
+modified_time(std::string const &path, timespec &modified) noexcept {
+  struct stat st;
+  if (stat(path.c_str(), &st) < 0) {
+    return false;
+  }
+  modified = st.st_mtim;
+  return true;
+}
+
+//! dlopen a private copy: the build may overwrite the original, and an unchanged path could be served from the
+//! loader's cache instead of being reloaded
+[[nodiscard]] static void *
+open_shadow_copy(std::string const &path) noexcept {
+  int const source{open(path.c_str(), O_RDONLY)};
+  if (source < 0) {
+    return nullptr;
+  }
+  std::string shadow{"/tmp/advent-plugin-XXXXXX.so"};
+  int const target{mkstemps(shadow.data(), 3)};
+  if (target < 0) {
+    (void)close(source);
+    return nullptr;
+  }
+  struct stat st;
+  bool copied{fstat(source, &st) == 0};
+  for (off_t offset{0}; copied and offset < st.st_size;) {
+    copied = sendfile(target, source, &offset, as<usize>(st.st_size - offset)) > 0;
+  }
+  (void)close(source);
+  (void)close(target);
+  void *handle{copied ? dlopen(shadow.c_str(), RTLD_NOW | RTLD_LOCAL) : nullptr};
+  if (copied and handle == nullptr) {
+    (void)fprintf(stderr, "%s\n", dlerror());
+  }
+  (void)unlink(shadow.c_str());
+  return handle;
+}
+
+day_plugin::day_plugin(std::string path) noexcept
+    : m_path{std::move(path)} {
+  (void)load();
+}
+
+day_plugin::~day_plugin() noexcept {
+  unload();
+}
+
+day_plugin::operator bool() const noexcept {
+  return m_state != nullptr;
+}
+
+bool
+day_plugin::load() noexcept {
+  // the modification time is only recorded once the load succeeds, so a failed load (a half-written library, say)
+  // is retried on the next check
+  timespec modified;
+  if (not modified_time(m_path, modified)) {
+    return false;
+  }
+  m_handle = open_shadow_copy(m_path);
+  if (m_handle == nullptr) {
+    return false;
+  }
+  auto const symbol = [this]<typename Fn>(char const *name, Fn &fn) noexcept {
+    fn = reinterpret_cast<Fn>(dlsym(m_handle, name));
+    return fn != nullptr;
+  };
+  advent_plugin_abi_fn abi{nullptr};
+  if (not(symbol("advent_plugin_abi", abi) and symbol("advent_plugin_day", m_day) and
+          symbol("advent_plugin_create", m_create) and symbol("advent_plugin_destroy", m_destroy) and
+          symbol("advent_plugin_parse", m_parse) and symbol("advent_plugin_part1", m_part1) and
+          symbol("advent_plugin_part2", m_part2) and symbol("advent_plugin_format", m_format)) or
+      abi() != advent_plugin_abi_version) {
+    (void)fprintf(stderr, "%s is not an advent plugin (ABI v%u)\n", m_path.c_str(), advent_plugin_abi_version);
+    unload();
+    return false;
+  }
+  m_state = m_create();
+  m_modified = modified;
+  return true;
+}
+
+void
+day_plugin::unload() noexcept {
+  if (m_state != nullptr) {
+    m_destroy(m_state);
+    m_state = nullptr;
+  }
+  if (m_handle != nullptr) {
+    (void)dlclose(m_handle);
+    m_handle = nullptr;
+  }
+}
+
+[[nodiscard]] bool
+day_plugin::reload_if_changed() noexcept {
+  timespec current;
+  if (not modified_time(m_path, current) or same_time(current, m_modified)) {
+    return false;
+  }
+  unload();
+  return load();
+}
+
+[[nodiscard]] timing_data
+day_plugin::run(std::string_view input) noexcept {
+  time_point t0 = clock_type::now();
+  m_parse(m_state, input.data(), input.size());
+  time_point t1 = clock_type::now();
+  m_part1(m_state);
+  time_point t2 = clock_type::now();
+  m_part2(m_state);
+  time_point t3 = clock_type::now();
+  return {time_in_us(t0, t1), time_in_us(t1, t2), time_in_us(t2, t3)};
+}
+
+[[nodiscard]] std::string
+day_plugin::answer(u32 part) const noexcept {
+  std::string result(32, '\0');
+  usize const length{m_format(m_state, part, result.data(), result.size())};
+  if (length > result.size()) {
+    result.resize(length);
+    (void)m_format(m_state, part, result.data(), result.size());
+  }
+  result.resize(length);
+  return result;
+}
+
+[[nodiscard]] u32
+day_plugin::day() const noexcept {
+  return m_day();
+}
+
+[[nodiscard]] std::string const &
+day_plugin::path() const noexcept {
+  return m_path;
+}
@@ -0,0 +1,194 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "environment.hpp"
+#include "file_backed_buffer.hpp"
+#include "server.hpp"
+
+namespace server {
+
+[[nodiscard]] static bool
+read_exact(int fd, void *buffer, usize length) noexcept {
+  auto *ptr = reinterpret_cast<char *>(buffer);
+  while (length > 0) {
+    ssize_t const count{recv(fd, ptr, length, 0)};
+    if (count < 0 and errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    ptr += count;
+    length -= as<usize>(count);
+  }
+  return true;
+}
+
+[[nodiscard]] static bool
+write_exact(int fd, void const *buffer, usize length) noexcept {
+  auto const *ptr = reinterpret_cast<char const *>(buffer);
+  while (length > 0) {
+    ssize_t const count{send(fd, ptr, length, MSG_NOSIGNAL)};
+    if (count < 0 and errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    ptr += count;
+    length -= as<usize>(count);
+  }
+  return true;
+}
+
+[[nodiscard]] static bool
+make_address(std::string const &path, sockaddr_un &addr) noexcept {
+  addr = sockaddr_un{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    return false;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return true;
+}
+
+[[nodiscard]] static bool
+send_reply(int fd, reply const &result) noexcept {
+  reply_header const header{.code = result.code,
+                            .parsing = result.timing.parsing,
+                            .part1 = result.timing.part1,
+                            .part2 = result.timing.part2,
+                            .part1_length = as<u32>(result.part1.size()),
+                            .part2_length = as<u32>(result.part2.size())};
+  return write_exact(fd, &header, sizeof(header)) and write_exact(fd, result.part1.data(), result.part1.size()) and
+         write_exact(fd, result.part2.data(), result.part2.size());
+}
+
+//! arena and file_path are the worker's scratch buffers; both are reused across requests
+static void
+handle_connection(int fd, handler_t handler, std::string &arena, std::string &file_path) noexcept {
+  request_header header;
+  while (read_exact(fd, &header, sizeof(header))) {
+    if (header.magic != magic or header.length > max_payload) {
+      (void)send_reply(fd, reply{.code = status::bad_request});
+      return;
+    }
+    // the arena is sized once per worker and only grows for a payload larger than any before it
+    if (header.length > arena.size()) {
+      arena.resize(header.length);
+    }
+    if (not read_exact(fd, arena.data(), header.length)) {
+      return;
+    }
+    std::string_view const payload{arena.data(), header.length};
+    bool sent{false};
+    if (header.kind == payload_kind::path) {
+      file_path.assign(payload);
+      file_backed_buffer const file{file_path};
+      sent = send_reply(fd, file ? handler(header.day, file.get_string_view()) : reply{.code = status::no_input});
+    } else if (header.kind == payload_kind::bytes) {
+      sent = send_reply(fd, handler(header.day, payload));
+    } else {
+      sent = send_reply(fd, reply{.code = status::bad_request});
+    }
+    if (not sent) {
+      return;
+    }
+  }
+}
+
+[[nodiscard]] bool
+listen_and_serve(std::string const &path, handler_t handler, std::span<u32 const> cpus, u32 workers) noexcept {
+  sockaddr_un addr;
+  if (not make_address(path, addr)) {
+    (void)fprintf(stderr, "Socket path is too long: %s\n", path.c_str());
+    return false;
+  }
+  int const listener{socket(AF_UNIX, SOCK_STREAM, 0)};
+  if (listener < 0) {
+    perror("socket");
+    return false;
+  }
+  (void)unlink(path.c_str());
+  if (bind(listener, reinterpret_cast<sockaddr const *>(&addr), sizeof(addr)) < 0 or listen(listener, SOMAXCONN) < 0) {
+    perror("bind");
+    (void)close(listener);
+    return false;
+  }
+
+  std::vector<std::thread> pool;
+  pool.reserve(workers);
+  for (u32 w{0}; w < workers; ++w) {
+    pool.emplace_back([=] {
+      // one CPU per worker, wrapping around when there are more workers than CPUs
+      if (not cpus.empty()) {
+        (void)pin_current_thread(cpus.subspan(w % std::size(cpus), 1));
+      }
+      std::string arena(arena_size, '\0');
+      std::string file_path;
+      while (true) {
+        int const client{accept(listener, nullptr, nullptr)};
+        if (client < 0) {
+          if (errno == EINTR or errno == ECONNABORTED) {
+            continue;
+          }
+          return;
+        }
+        handle_connection(client, handler, arena, file_path);
+        (void)close(client);
+      }
+    });
+  }
+  for (auto &worker : pool) {
+    worker.join();
+  }
+  (void)close(listener);
+  (void)unlink(path.c_str());
+  return true;
+}
+
+[[nodiscard]] int
+connect_to(std::string const &path) noexcept {
+  sockaddr_un addr;
+  if (not make_address(path, addr)) {
+    return -1;
+  }
+  int const fd{socket(AF_UNIX, SOCK_STREAM, 0)};
+  if (fd < 0) {
+    return -1;
+  }
+  if (connect(fd, reinterpret_cast<sockaddr const *>(&addr), sizeof(addr)) < 0) {
+    (void)close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+[[nodiscard]] bool
+send_request(int fd, u32 day, payload_kind kind, std::string_view payload) noexcept {
+  request_header const header{.day = as<u8>(day), .kind = kind, .length = as<u32>(payload.size())};
+  return write_exact(fd, &header, sizeof(header)) and write_exact(fd, payload.data(), payload.size());
+}
+
+[[nodiscard]] bool
+receive_reply(int fd, reply &result) noexcept {
+  reply_header header;
+  if (not read_exact(fd, &header, sizeof(header)) or header.magic != magic) {
+    return false;
+  }
+  result.code = header.code;
+  result.timing = timing_data{header.parsing, header.part1, header.part2};
+  result.part1.resize(header.part1_length);
+  result.part2.resize(header.part2_length);
+  return read_exact(fd, result.part1.data(), header.part1_length) and
+         read_exact(fd, result.part2.data(), header.part2_length);
+}
+
+} // namespace server
@@ -0,0 +1,28 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "startup.hpp"
+#include "types.hpp"
+
+startup_profile startup{};
+
+[[gnu::constructor(101)]] static void
+mark_first_initializer() noexcept {
+  startup.first_initializer_wall = std::chrono::system_clock::now();
+  startup.first_initializer = clock_type::now();
+}
+
+void
+startup_profile::report() const noexcept {
+  (void)fprintf(stderr, "startup profile (μs)\n");
+  if (char const *launch = getenv("ADVENT_LAUNCH_NS"); launch != nullptr) {
+    std::chrono::system_clock::time_point const launched{std::chrono::nanoseconds{strtoll(launch, nullptr, 10)}};
+    double const loading{std::chrono::duration<double, std::micro>(first_initializer_wall - launched).count()};
+    (void)fprintf(stderr, "  exec + dynamic loading : %.2f\n", loading);
+  }
+  (void)fprintf(stderr, "  static initializers    : %.2f\n", time_in_us(first_initializer, main_entry));
+  (void)fprintf(stderr, "  option parsing         : %.2f\n", time_in_us(main_entry, options_parsed));
+  (void)fprintf(stderr, "  first solve            : %.2f\n", time_in_us(options_parsed, first_solve));
+  (void)fprintf(stderr, "  remaining solves       : %.2f\n", time_in_us(first_solve, all_solved));
+  (void)fprintf(stderr, "  time to first solve    : %.2f\n", time_in_us(first_initializer, first_solve));
+}
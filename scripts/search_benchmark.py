@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""Compare the grid-search variants of Day12 and Day18 on scaled-up inputs.
+
+Usage: search_benchmark.py [--scale K] [--runs N] <advent binary>
+
+Day12's height map is tiled KxK with every other tile mirrored, so squares meet
+their own copy across each seam and stay walkable; only the first S and the
+last E are kept. Day18's droplet is repeated KxKxK times with a gap between
+copies. Each scaled input is written to input/dayNN.txt of a scratch directory,
+where `<binary> -d NN -A -b N` runs every variant of the day side by side.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+
+def scale_day12(text: str, k: int) -> str:
+    rows = text.split()
+    width, height = len(rows[0]), len(rows)
+    sy, sx = divmod(text.index("S"), width + 1)
+    ey, ex = divmod(text.index("E"), width + 1)
+    tiles = []
+    for ty in range(k):
+        for row in rows if ty % 2 == 0 else rows[::-1]:
+            tiles.append(list("".join(row if tx % 2 == 0 else row[::-1] for tx in range(k))))
+    for row in tiles:
+        for x, c in enumerate(row):
+            row[x] = {"S": "a", "E": "z"}.get(c, c)
+    tiles[sy][sx] = "S"
+    # the last tile is mirrored along both axes when K is even
+    if k % 2 == 0:
+        ex, ey = width - 1 - ex, height - 1 - ey
+    tiles[(k - 1) * height + ey][(k - 1) * width + ex] = "E"
+    return "".join("".join(row) + "\n" for row in tiles)
+
+
+def scale_day18(text: str, k: int) -> str:
+    cubes = [tuple(map(int, line.split(","))) for line in text.split()]
+    gap = max(max(c) for c in cubes) + 2
+    out = []
+    for dz in range(k):
+        for dy in range(k):
+            for dx in range(k):
+                out.extend(f"{x + dx * gap},{y + dy * gap},{z + dz * gap}" for x, y, z in cubes)
+    return "\n".join(out) + "\n"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--scale", type=int, default=4)
+    parser.add_argument("--runs", type=int, default=20)
+    parser.add_argument("binary")
+    args = parser.parse_args()
+
+    binary = os.path.abspath(args.binary)
+    with tempfile.TemporaryDirectory() as scratch:
+        os.mkdir(os.path.join(scratch, "input"))
+        for day, scale in ((12, scale_day12), (18, scale_day18)):
+            with open(f"input/day{day:02}.txt") as source:
+                scaled = scale(source.read(), args.scale)
+            with open(os.path.join(scratch, "input", f"day{day:02}.txt"), "w") as target:
+                target.write(scaled)
+            print(f"Day {day} scaled {args.scale}x per axis ({len(scaled)} bytes)", flush=True)
+            subprocess.run([binary, "-d", str(day), "-A", "-b", str(args.runs)], cwd=scratch, check=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
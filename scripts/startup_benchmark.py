@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Compare `-m` startup + solve latency across advent build variants.
+
+Usage: startup_benchmark.py [--runs N] <binary> [<binary> ...]
+
+Each binary is launched N times as `<binary> -P -m` from the repository root.
+Wall time is measured around the whole process. The in-process breakdown
+comes from the `-P` startup profile; ADVENT_LAUNCH_NS is set just before
+spawning so exec + dynamic loading is included.
+"""
+
+import argparse
+import os
+import statistics
+import subprocess
+import sys
+import time
+
+
+def run_once(binary: str) -> tuple[float, dict[str, float]]:
+    env = dict(os.environ)
+    env["ADVENT_LAUNCH_NS"] = str(time.time_ns())
+    start = time.perf_counter_ns()
+    proc = subprocess.run([binary, "-P", "-m"], env=env, capture_output=True, text=True, check=True)
+    wall = (time.perf_counter_ns() - start) / 1000.0
+    phases: dict[str, float] = {}
+    for line in proc.stderr.splitlines():
+        if line.startswith("  ") and ":" in line:
+            name, value = line.rsplit(":", 1)
+            phases[name.strip()] = float(value)
+    return wall, phases
+
+
+def summarize(binary: str, runs: int) -> tuple[list[float], dict[str, list[float]]]:
+    walls: list[float] = []
+    phases: dict[str, list[float]] = {}
+    run_once(binary)  # warm the page cache
+    for _ in range(runs):
+        wall, phase = run_once(binary)
+        walls.append(wall)
+        for name, value in phase.items():
+            phases.setdefault(name, []).append(value)
+    return walls, phases
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--runs", type=int, default=50)
+    parser.add_argument("binaries", nargs="+")
+    args = parser.parse_args()
+
+    results = {b: summarize(b, args.runs) for b in args.binaries}
+    names = [os.path.basename(b) for b in args.binaries]
+    phase_names = list(next(iter(results.values()))[1].keys())
+
+    width = max(len(n) for n in ["wall (median)", "wall (p90)", *phase_names]) + 2
+    print(f"{'median μs over ' + str(args.runs) + ' runs':<{width}}" + "".join(f"{n:>16}" for n in names))
+    walls = [sorted(results[b][0]) for b in args.binaries]
+    print(f"{'wall (median)':<{width}}" + "".join(f"{statistics.median(w):>16.1f}" for w in walls))
+    print(f"{'wall (p90)':<{width}}" + "".join(f"{w[int(0.9 * (len(w) - 1))]:>16.1f}" for w in walls))
+    for phase in phase_names:
+        row = [statistics.median(results[b][1].get(phase, [0.0])) for b in args.binaries]
+        print(f"{phase:<{width}}" + "".join(f"{v:>16.1f}" for v in row))
+    if len(walls) > 1:
+        base = statistics.median(walls[0])
+        print(f"{'speedup vs ' + names[0]:<{width}}" + "".join(f"{base / statistics.median(w):>15.2f}x" for w in walls))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())